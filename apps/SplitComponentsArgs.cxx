@@ -2,6 +2,28 @@
 
 #include "metaCommand.h"
 
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <sstream>
+
+std::string
+Args::DefaultOutputPrefix(const std::string & inputImage)
+{
+  // truncate the input extension
+  std::string fileBase = inputImage;
+  size_t      fileBaseLength = fileBase.length();
+  if (fileBaseLength > 4)
+  {
+    if (!inputImage.compare(fileBaseLength - 4, 1, "."))
+    {
+      fileBase = fileBase.substr(0, fileBaseLength - 4);
+    }
+  }
+  return fileBase;
+}
+
+
 Args::Args(int argc, char * argv[])
 {
   MetaCommand command;
@@ -9,12 +31,113 @@ Args::Args(int argc, char * argv[])
  or symmetric second rank tensors into its components.");
   command.SetAuthor("Matthew McCormick");
 
-  command.AddField("inputImage", "Input image.", MetaCommand::STRING, MetaCommand::DATA_IN);
+  command.AddField("inputImage", "Input image, or manifest with --batch.", MetaCommand::STRING, MetaCommand::DATA_IN);
 
   command.SetOption("outputPrefix", "o", false, "Output image prefix.  Optional.");
   command.SetOptionLongTag("outputPrefix", "output");
   command.AddOptionField("outputPrefix", "outputPrefix", MetaCommand::STRING, true, "", "", MetaCommand::DATA_OUT);
 
+  command.SetOption("components",
+                    "c",
+                    false,
+                    "Comma separated list of the components to write, e.g. 0,2,5, in the order of the planes of "
+                    "--planar.  Optional.");
+  command.SetOptionLongTag("components", "components");
+  command.AddOptionField("components", "components", MetaCommand::STRING, true);
+
+  command.SetOption("stats", "s", false, "Print the timings and throughput of the read, split and write stages.");
+  command.SetOptionLongTag("stats", "stats");
+
+  command.SetOption(
+    "statistics", "t", false, "Write the statistics and histogram of each component to this JSON file.");
+  command.SetOptionLongTag("statistics", "statistics");
+  command.AddOptionField("statistics", "statisticsFile", MetaCommand::STRING, true, "", "", MetaCommand::DATA_OUT);
+
+  command.SetOption("histogramBins", "b", false, "Number of histogram bins for --statistics.  Default 256.");
+  command.SetOptionLongTag("histogramBins", "histogram-bins");
+  command.AddOptionField("histogramBins", "histogramBins", MetaCommand::INT, true, "256");
+
+  command.SetOption("histogramRange",
+                    "r",
+                    false,
+                    "Histogram range for --statistics, e.g. -1.0,1.0.  Defaults to the range of integer pixel types; "
+                    "required for a histogram of floating point pixels.");
+  command.SetOptionLongTag("histogramRange", "histogram-range");
+  command.AddOptionField("histogramRange", "histogramRange", MetaCommand::STRING, true);
+
+  command.SetOption("maxMemory",
+                    "m",
+                    false,
+                    "Memory budget for the pieces of the input and of the components held at once, in bytes or with "
+                    "a K, M or G suffix, e.g. 512M.  The input is streamed in as many pieces as needed.  Optional.");
+  command.SetOptionLongTag("maxMemory", "max-memory");
+  command.AddOptionField("maxMemory", "maxMemory", MetaCommand::STRING, true);
+
+  command.SetOption("writerThreads",
+                    "w",
+                    false,
+                    "Number of threads writing the component files concurrently.  Default: one per hardware thread.");
+  command.SetOptionLongTag("writerThreads", "writer-threads");
+  command.AddOptionField("writerThreads", "writerThreads", MetaCommand::INT, true);
+
+  command.SetOption("mmap",
+                    "M",
+                    false,
+                    "Split the components straight into memory mapped files, written as a MetaImage header (.mhd) "
+                    "and raw data (.raw) per component.");
+  command.SetOptionLongTag("mmap", "mmap");
+
+  command.SetOption("planar",
+                    "p",
+                    false,
+                    "Write the selected components, in order, as the planes of a single <prefix>Components file with "
+                    "an extra, slowest axis, instead of a file per component.");
+  command.SetOptionLongTag("planar", "planar");
+
+  command.SetOption("compress",
+                    "z",
+                    false,
+                    "Compress the output files.  The data is cut into chunks that are compressed on all the writer "
+                    "threads.");
+  command.SetOptionLongTag("compress", "compress");
+
+  command.SetOption("compressionLevel", "l", false, "zlib compression level, 1-9, for --compress.  Default 6.");
+  command.SetOptionLongTag("compressionLevel", "compression-level");
+  command.AddOptionField("compressionLevel", "compressionLevel", MetaCommand::INT, true, "6");
+
+  command.SetOption("firstTouch",
+                    "f",
+                    false,
+                    "Allocate the components afresh for each piece, instead of reusing the buffers of the previous "
+                    "piece, and write their pages first on the threads that split them, so that on NUMA systems "
+                    "each thread writes to memory local to its node.");
+  command.SetOptionLongTag("firstTouch", "first-touch");
+
+  command.SetOption("axis",
+                    "a",
+                    false,
+                    "Split a scalar image along this axis, e.g. 3 for the frames of a 4D time series, into an image "
+                    "of one dimension less per slice, instead of splitting its components.  --components then "
+                    "selects the slices.");
+  command.SetOptionLongTag("axis", "axis");
+  command.AddOptionField("axis", "axis", MetaCommand::INT, true);
+
+  command.SetOption("batch",
+                    "B",
+                    false,
+                    "Read the input as a manifest with a line per image: the input image, and optionally its output "
+                    "prefix, separated by whitespace.  Blank lines and lines starting with # are skipped.  The images "
+                    "are read, split and written concurrently in one process.");
+  command.SetOptionLongTag("batch", "batch");
+
+  command.SetOption("queueDepth",
+                    "q",
+                    false,
+                    "Number of images that may wait between the read, split and write stages of --batch, which bounds "
+                    "the images held at once to twice this plus three.  Default 2.");
+  command.SetOptionLongTag("queueDepth", "queue-depth");
+  command.AddOptionField("queueDepth", "queueDepth", MetaCommand::INT, true, "2");
+
   if (!command.Parse(argc, argv))
   {
     if (command.GotXMLFlag())
@@ -28,19 +151,150 @@ Args::Args(int argc, char * argv[])
   this->inputImage = command.GetValueAsString("inputImage");
 
   if (!command.GetOptionWasSet("outputPrefix"))
+    this->outputPrefix = DefaultOutputPrefix(this->inputImage);
+  else
+    this->outputPrefix = command.GetValueAsString("outputPrefix", "outputPrefix");
+
+  if (command.GetOptionWasSet("components"))
   {
-    // truncate the input extension
-    std::string fileBase = this->inputImage;
-    size_t      fileBaseLength = fileBase.length();
-    if (fileBaseLength > 4)
+    std::istringstream componentsStream(command.GetValueAsString("components", "components"));
+    std::string        component;
+    while (std::getline(componentsStream, component, ','))
     {
-      if (!this->inputImage.compare(fileBaseLength - 4, 1, "."))
+      // std::stoul would accept a sign and wrap a negative index around.
+      std::size_t   parsed = 0;
+      unsigned long index = 0;
+      if (!component.empty() && std::isdigit(static_cast<unsigned char>(component.front())))
       {
-        fileBase = fileBase.substr(0, fileBaseLength - 4);
+        try
+        {
+          index = std::stoul(component, &parsed);
+        }
+        catch (const std::logic_error &)
+        {
+          parsed = 0;
+        }
       }
+      if (parsed == 0 || parsed != component.size() || index > std::numeric_limits<unsigned int>::max())
+        throw std::runtime_error("Invalid component index: '" + component + "'.");
+      // The order given is that of the planes of --planar; a repeated
+      // component is written once.
+      const auto componentIndex = static_cast<unsigned int>(index);
+      if (std::find(this->components.begin(), this->components.end(), componentIndex) == this->components.end())
+        this->components.push_back(componentIndex);
     }
-    this->outputPrefix = fileBase;
+    if (this->components.empty())
+      throw std::runtime_error("No components given to --components.");
   }
-  else
-    this->outputPrefix = command.GetValueAsString("outputPrefix", "outputPrefix");
+
+  this->stats = command.GetOptionWasSet("stats");
+
+  if (command.GetOptionWasSet("statistics"))
+    this->statisticsFile = command.GetValueAsString("statistics", "statisticsFile");
+  if (command.GetOptionWasSet("histogramBins"))
+  {
+    const int bins = command.GetValueAsInt("histogramBins", "histogramBins");
+    if (bins < 0)
+      throw std::runtime_error("The number of histogram bins must not be negative.");
+    this->histogramBins = static_cast<unsigned int>(bins);
+  }
+  if (command.GetOptionWasSet("histogramRange"))
+  {
+    const std::string  range = command.GetValueAsString("histogramRange", "histogramRange");
+    std::istringstream rangeStream(range);
+    char               comma = '\0';
+    if (!(rangeStream >> this->histogramLowerBound >> comma >> this->histogramUpperBound) || comma != ',' ||
+        !(this->histogramLowerBound < this->histogramUpperBound))
+      throw std::runtime_error("Invalid histogram range: '" + range + "'.");
+    this->histogramRangeSet = true;
+  }
+
+  if (command.GetOptionWasSet("maxMemory"))
+  {
+    const std::string memory = command.GetValueAsString("maxMemory", "maxMemory");
+    std::size_t       parsed = 0;
+    unsigned long     amount = 0;
+    if (!memory.empty() && std::isdigit(static_cast<unsigned char>(memory.front())))
+    {
+      try
+      {
+        amount = std::stoul(memory, &parsed);
+      }
+      catch (const std::logic_error &)
+      {
+        parsed = 0;
+      }
+    }
+    std::size_t multiplier = 1;
+    if (parsed > 0 && parsed + 1 == memory.size())
+    {
+      switch (memory[parsed])
+      {
+        case 'K':
+        case 'k':
+          multiplier = std::size_t{ 1 } << 10;
+          ++parsed;
+          break;
+        case 'M':
+        case 'm':
+          multiplier = std::size_t{ 1 } << 20;
+          ++parsed;
+          break;
+        case 'G':
+        case 'g':
+          multiplier = std::size_t{ 1 } << 30;
+          ++parsed;
+          break;
+      }
+    }
+    if (parsed == 0 || parsed != memory.size() || amount == 0 ||
+        amount > std::numeric_limits<std::size_t>::max() / multiplier)
+      throw std::runtime_error("Invalid memory budget: '" + memory + "'.");
+    this->maxMemory = amount * multiplier;
+  }
+
+  if (command.GetOptionWasSet("writerThreads"))
+  {
+    const int threads = command.GetValueAsInt("writerThreads", "writerThreads");
+    if (threads < 1)
+      throw std::runtime_error("The number of writer threads must be positive.");
+    this->writerThreads = static_cast<unsigned int>(threads);
+  }
+
+  this->mapOutput = command.GetOptionWasSet("mmap");
+  this->planar = command.GetOptionWasSet("planar");
+  this->compress = command.GetOptionWasSet("compress");
+  if (command.GetOptionWasSet("compressionLevel"))
+  {
+    this->compressionLevel = command.GetValueAsInt("compressionLevel", "compressionLevel");
+    if (this->compressionLevel < 1 || this->compressionLevel > 9)
+      throw std::runtime_error("The compression level must be between 1 and 9.");
+    this->compress = true;
+  }
+  if (this->compress && this->mapOutput)
+    throw std::runtime_error("Memory mapped output files cannot be compressed.");
+
+  this->firstTouch = command.GetOptionWasSet("firstTouch");
+
+  if (command.GetOptionWasSet("axis"))
+  {
+    this->axis = command.GetValueAsInt("axis", "axis");
+    if (this->axis < 0)
+      throw std::runtime_error("The axis must not be negative.");
+  }
+
+  this->batch = command.GetOptionWasSet("batch");
+  if (command.GetOptionWasSet("queueDepth"))
+  {
+    const int depth = command.GetValueAsInt("queueDepth", "queueDepth");
+    if (depth < 1)
+      throw std::runtime_error("The queue depth must be positive.");
+    this->queueDepth = static_cast<unsigned int>(depth);
+  }
+  if (this->batch && (!this->statisticsFile.empty() || this->maxMemory > 0 || this->mapOutput))
+    throw std::runtime_error("--statistics, --max-memory and --mmap apply to a single input, not to --batch.");
+  if (this->axis >= 0 && (this->batch || this->planar || this->compress || this->mapOutput ||
+                          !this->statisticsFile.empty() || this->maxMemory > 0))
+    throw std::runtime_error(
+      "--axis cannot be combined with --batch, --planar, --compress, --mmap, --statistics or --max-memory.");
 }
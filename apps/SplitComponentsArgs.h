@@ -1,8 +1,10 @@
 #ifndef __SplitComponentsArgs_h
 #define __SplitComponentsArgs_h
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 /**
  * @brief hold the results of command line argument parsing.
@@ -11,9 +13,51 @@ struct Args
 {
   std::string inputImage;
   std::string outputPrefix;
+  // Components to write, in the order given.  Empty means all of them.
+  std::vector<unsigned int> components;
+  // Print timings and throughput of the read, split and write stages.
+  bool stats = false;
+  // JSON file to write the statistics of the components to.  Empty means
+  // none.
+  std::string statisticsFile;
+  // Number of histogram bins, and their range when it was given.
+  unsigned int histogramBins = 256;
+  bool         histogramRangeSet = false;
+  double       histogramLowerBound = 0.0;
+  double       histogramUpperBound = 0.0;
+  // Memory budget in bytes for the input and component pieces held at once.
+  // Zero means no budget.
+  std::size_t maxMemory = 0;
+  // Number of threads writing the component files.  Zero means one per
+  // hardware thread.
+  unsigned int writerThreads = 0;
+  // Split the components into memory mapped .mhd/.raw files.
+  bool mapOutput = false;
+  // Write the components as the planes of a single file with an extra,
+  // slowest axis, instead of a file per component.
+  bool planar = false;
+  // Compress the output files, and the zlib compression level.
+  bool compress = false;
+  int  compressionLevel = 6;
+  // Place the pages of the components on the NUMA nodes of the threads
+  // that split them.
+  bool firstTouch = false;
+  // Split a scalar image along this axis into images of one dimension less,
+  // instead of into its components.  Negative means the components.
+  int axis = -1;
+  // Treat the input as a manifest of input images and output prefixes, and
+  // split them all in one process.
+  bool batch = false;
+  // Number of images that may wait between the read, split and write stages
+  // of the batch mode.
+  unsigned int queueDepth = 2;
 
   Args(int argc, char * argv[]);
 
+  // Output prefix used when none is given: the input without its extension.
+  static std::string
+  DefaultOutputPrefix(const std::string & inputImage);
+
   // Just so we can distinguish it.
   class got_xml_flag_exception : public std::logic_error
   {
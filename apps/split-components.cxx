@@ -5,906 +5,1590 @@
 #include "SplitComponentsArgs.h"
 
 
+#include "itkSplitAxisImageFilter.h"
 #include "itkSplitComponentsImageFilter.h"
 
+#include "itkByteSwapper.h"
 #include "itkImageFileReader.h"
-#include "itkImageFileWriter.h"
 #include "itkImageIOBase.h"
 #include "itkImageIOFactory.h"
+#include "itkImageIORegion.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkTimeProbe.h"
+#include "itk_zlib.h"
+#include "itksys/SystemTools.hxx"
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-template <class TPixel, unsigned int TDimension, unsigned int TComponents>
+#if defined(__unix__) || defined(__APPLE__)
+#  define SPLIT_COMPONENTS_MAPPED_FILES
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+// Quote a string for JSON.
+std::string
+JSONString(const std::string & value)
+{
+  std::string quoted = "\"";
+  for (const char c : value)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + '"';
+}
+
+
+// Write the statistics of the components to a JSON sidecar.
+void
+WriteStatistics(const std::string &                           fileName,
+                const std::string &                           inputImage,
+                const std::vector<unsigned int> &             components,
+                const std::vector<std::string> &              outputFiles,
+                const std::vector<itk::ComponentStatistics> & statistics)
+{
+  std::ofstream json(fileName);
+  if (!json)
+  {
+    throw std::runtime_error("Could not write " + fileName);
+  }
+  json << std::setprecision(std::numeric_limits<double>::max_digits10);
+  json << "{\n  \"input\": " << JSONString(inputImage) << ",\n  \"components\": [";
+  for (std::size_t i = 0; i < components.size(); ++i)
+  {
+    const itk::ComponentStatistics & componentStatistics = statistics[i];
+    json << (i == 0 ? "\n" : ",\n") << "    {\n"
+         << "      \"component\": " << components[i] << ",\n"
+         << "      \"file\": " << JSONString(outputFiles[i]) << ",\n"
+         << "      \"count\": " << componentStatistics.GetCount() << ",\n"
+         << "      \"minimum\": " << componentStatistics.GetMinimum() << ",\n"
+         << "      \"maximum\": " << componentStatistics.GetMaximum() << ",\n"
+         << "      \"mean\": " << componentStatistics.GetMean() << ",\n"
+         << "      \"variance\": " << componentStatistics.GetVariance();
+    const itk::ComponentStatistics::HistogramType & histogram = componentStatistics.GetHistogram();
+    if (!histogram.empty())
+    {
+      json << ",\n      \"histogram\": {\n"
+           << "        \"lower_bound\": " << componentStatistics.GetHistogramLowerBound() << ",\n"
+           << "        \"upper_bound\": " << componentStatistics.GetHistogramUpperBound() << ",\n"
+           << "        \"counts\": [";
+      for (std::size_t bin = 0; bin < histogram.size(); ++bin)
+      {
+        json << (bin == 0 ? "" : ", ") << histogram[bin];
+      }
+      json << "]\n      }";
+    }
+    json << "\n    }";
+  }
+  json << "\n  ]\n}\n";
+}
+
+
+// The components selected on the command line, or all of them.
+std::vector<unsigned int>
+SelectedComponents(const Args & args, unsigned int numberOfComponents)
+{
+  std::vector<unsigned int> components = args.components;
+  if (components.empty())
+  {
+    for (unsigned int i = 0; i < numberOfComponents; ++i)
+    {
+      components.push_back(i);
+    }
+  }
+  for (const unsigned int component : components)
+  {
+    if (component >= numberOfComponents)
+    {
+      std::ostringstream message;
+      message << "Component " << component << " requested, but the input has " << numberOfComponents
+              << " components.";
+      throw std::runtime_error(message.str());
+    }
+  }
+  return components;
+}
+
+
+std::string
+ComponentFileName(const std::string & outputPrefix, unsigned int component, const char * extension)
+{
+  std::ostringstream fileName;
+  fileName << outputPrefix << "Component" << component << extension;
+  return fileName.str();
+}
+
+
+// A bounded pool of threads writing the output files, separate from the
+// threads of the ITK multi-threader that split the components.  The threads
+// live as long as the pool, which is created once per run.
+class WriterThreadPool
+{
+public:
+  // The thread calling ParallelFor works alongside the numberOfThreads - 1
+  // threads of the pool.
+  explicit WriterThreadPool(unsigned int numberOfThreads)
+  {
+    for (unsigned int t = 1; t < numberOfThreads; ++t)
+    {
+      m_Threads.emplace_back([this]() { this->Work(); });
+    }
+  }
+
+  ~WriterThreadPool()
+  {
+    {
+      const std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_JobAdded.notify_all();
+    for (std::thread & thread : m_Threads)
+    {
+      thread.join();
+    }
+  }
+
+  WriterThreadPool(const WriterThreadPool &) = delete;
+  WriterThreadPool &
+  operator=(const WriterThreadPool &) = delete;
+
+  unsigned int
+  GetNumberOfThreads() const
+  {
+    return static_cast<unsigned int>(m_Threads.size()) + 1;
+  }
+
+  // Run task(i) for every i in [0, count) on up to numberOfThreads threads,
+  // the calling thread included, and rethrow the first exception of a task.
+  // The calling thread takes tasks until none are left, so a task may itself
+  // call ParallelFor.
+  template <typename TTask>
+  void
+  ParallelFor(std::size_t count, unsigned int numberOfThreads, const TTask & task)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    Job job;
+    job.task = [&task](std::size_t i) { task(i); };
+    job.count = count;
+    job.maximumWorkers = std::max(1u, numberOfThreads);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (count > 1 && job.maximumWorkers > 1 && !m_Threads.empty())
+    {
+      m_Jobs.push_back(&job);
+      m_JobAdded.notify_all();
+    }
+    this->RunJob(job, lock);
+    m_JobDone.wait(lock, [&job]() { return job.done == job.count; });
+    lock.unlock();
+    if (job.error)
+    {
+      std::rethrow_exception(job.error);
+    }
+  }
+
+  // As above on all the threads of the pool.
+  template <typename TTask>
+  void
+  ParallelFor(std::size_t count, const TTask & task)
+  {
+    this->ParallelFor(count, this->GetNumberOfThreads(), task);
+  }
+
+private:
+  struct Job
+  {
+    std::function<void(std::size_t)> task;
+    std::size_t                      count{ 0 };
+    std::size_t                      next{ 0 };
+    std::size_t                      done{ 0 };
+    unsigned int                     workers{ 0 };
+    unsigned int                     maximumWorkers{ 1 };
+    std::exception_ptr               error;
+  };
+
+  // Run the remaining tasks of a job, with m_Mutex held by lock except while
+  // a task runs.  The job leaves the queue once all its tasks are taken.
+  void
+  RunJob(Job & job, std::unique_lock<std::mutex> & lock)
+  {
+    ++job.workers;
+    while (job.next < job.count)
+    {
+      const std::size_t i = job.next++;
+      if (job.next == job.count)
+      {
+        m_Jobs.erase(std::remove(m_Jobs.begin(), m_Jobs.end(), &job), m_Jobs.end());
+      }
+      lock.unlock();
+      std::exception_ptr error;
+      try
+      {
+        job.task(i);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (error && !job.error)
+      {
+        job.error = error;
+      }
+      if (++job.done == job.count)
+      {
+        m_JobDone.notify_all();
+      }
+    }
+    --job.workers;
+  }
+
+  // A job with tasks left that may take another thread, or null.
+  Job *
+  NextJob() const
+  {
+    for (Job * job : m_Jobs)
+    {
+      if (job->workers < job->maximumWorkers)
+      {
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  void
+  Work()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true)
+    {
+      Job * job = nullptr;
+      m_JobAdded.wait(lock, [this, &job]() {
+        job = this->NextJob();
+        return m_Stop || job;
+      });
+      if (!job)
+      {
+        return;
+      }
+      this->RunJob(*job, lock);
+      // A job that was at its limit of threads may take this one now.
+      m_JobAdded.notify_all();
+    }
+  }
+
+  std::vector<std::thread> m_Threads;
+  std::deque<Job *>        m_Jobs;
+  bool                     m_Stop{ false };
+  std::mutex               m_Mutex;
+  std::condition_variable  m_JobAdded;
+  std::condition_variable  m_JobDone;
+};
+
+
+unsigned int
+WriterThreads(const Args & args)
+{
+  return args.writerThreads > 0 ? args.writerThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+// Look up an ImageIO for a file.  The lookups are serialized, since the
+// batch stages look up ImageIOs concurrently.
+itk::ImageIOBase::Pointer
+CreateImageIO(const std::string & fileName, itk::ImageIOFactory::IOFileModeEnum mode)
+{
+  static std::mutex                 factoryMutex;
+  const std::lock_guard<std::mutex> lock(factoryMutex);
+  return itk::ImageIOFactory::CreateImageIO(fileName.c_str(), mode);
+}
+
+
+// Writes the pieces of an image into its file, like a pasting
+// ImageFileWriter but through the ImageIO alone.  Without a pipeline to
+// update, the writers of several images can run concurrently.
+//
+// A planar file holds several images of the same size as the planes of an
+// extra, slowest axis, so each image is one contiguous range of the file.
+template <typename TImage>
+class ComponentFileWriter
+{
+public:
+  static constexpr unsigned int Dimension = TImage::ImageDimension;
+
+  // Set up the file for the largest possible region of the image, with
+  // numberOfPlanes planes when it is positive.
+  ComponentFileWriter(const std::string & fileName, const TImage * image, unsigned int numberOfPlanes = 0)
+    : m_LargestRegion(image->GetLargestPossibleRegion())
+  {
+    m_ImageIO = CreateImageIO(fileName, itk::ImageIOFactory::WriteMode);
+    if (!m_ImageIO)
+    {
+      throw std::runtime_error("No ImageIO found to write " + fileName);
+    }
+    typename TImage::PointType origin;
+    image->TransformIndexToPhysicalPoint(m_LargestRegion.GetIndex(), origin);
+    const unsigned int fileDimension = numberOfPlanes > 0 ? Dimension + 1 : Dimension;
+    m_ImageIO->SetNumberOfDimensions(fileDimension);
+    for (unsigned int i = 0; i < fileDimension; ++i)
+    {
+      // The plane axis has unit spacing and is orthogonal to the others.
+      std::vector<double> axis(fileDimension, 0.0);
+      if (i < Dimension)
+      {
+        m_ImageIO->SetDimensions(i, m_LargestRegion.GetSize(i));
+        m_ImageIO->SetSpacing(i, image->GetSpacing()[i]);
+        m_ImageIO->SetOrigin(i, origin[i]);
+        for (unsigned int j = 0; j < Dimension; ++j)
+        {
+          axis[j] = image->GetDirection()[j][i];
+        }
+      }
+      else
+      {
+        m_ImageIO->SetDimensions(i, numberOfPlanes);
+        m_ImageIO->SetSpacing(i, 1.0);
+        m_ImageIO->SetOrigin(i, 0.0);
+        axis[i] = 1.0;
+      }
+      m_ImageIO->SetDirection(i, axis);
+    }
+    m_ImageIO->SetPixelTypeInfo(static_cast<const typename TImage::PixelType *>(nullptr));
+    m_ImageIO->SetMetaDataDictionary(image->GetMetaDataDictionary());
+    m_ImageIO->SetUseStreamedWriting(true);
+    m_ImageIO->SetFileName(fileName);
+  }
+
+  // Paste the buffered region of the image into the file, or into a plane
+  // of a planar file.
+  void
+  Write(const TImage * piece, unsigned int plane = 0)
+  {
+    const typename TImage::RegionType & region = piece->GetBufferedRegion();
+    itk::ImageIORegion                  ioRegion(m_ImageIO->GetNumberOfDimensions());
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      ioRegion.SetIndex(i, region.GetIndex(i) - m_LargestRegion.GetIndex(i));
+      ioRegion.SetSize(i, region.GetSize(i));
+    }
+    if (ioRegion.GetImageDimension() > Dimension)
+    {
+      ioRegion.SetIndex(Dimension, plane);
+      ioRegion.SetSize(Dimension, 1);
+    }
+    m_ImageIO->SetIORegion(ioRegion);
+    m_ImageIO->Write(piece->GetBufferPointer());
+  }
+
+private:
+  itk::ImageIOBase::Pointer   m_ImageIO;
+  typename TImage::RegionType m_LargestRegion;
+};
+
+
+// Name of the MetaImage element type of a pixel type.
+template <typename TPixel>
+std::string
+MetaElementType()
+{
+  if constexpr (std::is_floating_point_v<TPixel>)
+  {
+    return sizeof(TPixel) == sizeof(float) ? "MET_FLOAT" : "MET_DOUBLE";
+  }
+  else
+  {
+    const std::string sign = std::is_signed_v<TPixel> ? "MET_" : "MET_U";
+    switch (sizeof(TPixel))
+    {
+      case 1:
+        return sign + "CHAR";
+      case 2:
+        return sign + "SHORT";
+      case 4:
+        return sign + "INT";
+      default:
+        return sign + "LONG_LONG";
+    }
+  }
+}
+
+
+// Write the fields of a MetaImage header that describe an image, or
+// numberOfPlanes planes of it as with ComponentFileWriter when it is
+// positive, up to the ElementDataFile field.  The data is compressed, of the
+// given size, unless compressedDataSize is empty.
+template <typename TImage>
+void
+WriteMetaImageHeader(std::ostream &      header,
+                     const TImage *      image,
+                     unsigned int        numberOfPlanes,
+                     const std::string & compressedDataSize)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+  using PixelType = typename TImage::PixelType;
+
+  const typename TImage::RegionType & largestRegion = image->GetLargestPossibleRegion();
+  typename TImage::PointType          origin;
+  image->TransformIndexToPhysicalPoint(largestRegion.GetIndex(), origin);
+
+  // The plane axis has unit spacing and is orthogonal to the others.
+  const unsigned int fileDimension = numberOfPlanes > 0 ? Dimension + 1 : Dimension;
+  header << std::setprecision(std::numeric_limits<double>::max_digits10);
+  header << "ObjectType = Image\nNDims = " << fileDimension << "\nBinaryData = True\nBinaryDataByteOrderMSB = "
+         << (itk::ByteSwapper<PixelType>::SystemIsBigEndian() ? "True" : "False");
+  if (compressedDataSize.empty())
+  {
+    header << "\nCompressedData = False";
+  }
+  else
+  {
+    header << "\nCompressedData = True\nCompressedDataSize = " << compressedDataSize;
+  }
+  header << "\nTransformMatrix =";
+  for (unsigned int i = 0; i < fileDimension; ++i)
+  {
+    for (unsigned int j = 0; j < fileDimension; ++j)
+    {
+      header << ' ' << (i < Dimension && j < Dimension ? image->GetDirection()[j][i] : (i == j ? 1.0 : 0.0));
+    }
+  }
+  header << "\nOffset =";
+  for (unsigned int i = 0; i < fileDimension; ++i)
+  {
+    header << ' ' << (i < Dimension ? origin[i] : 0.0);
+  }
+  header << "\nElementSpacing =";
+  for (unsigned int i = 0; i < fileDimension; ++i)
+  {
+    header << ' ' << (i < Dimension ? image->GetSpacing()[i] : 1.0);
+  }
+  header << "\nDimSize =";
+  for (unsigned int i = 0; i < fileDimension; ++i)
+  {
+    header << ' ' << (i < Dimension ? largestRegion.GetSize(i) : numberOfPlanes);
+  }
+  header << "\nElementType = " << MetaElementType<PixelType>() << '\n';
+}
+
+
+// Writes the pieces of an image into a compressed MetaImage file.  The
+// pieces are cut into chunks that are deflated independently on several
+// threads, and the chunks are joined into the single zlib stream any
+// MetaImage reader inflates: each chunk ends on a byte boundary with a sync
+// flush, and their checksums are combined.  The planes of a planar file, as
+// with ComponentFileWriter, may be written in any order; the pieces of a
+// plane must be written in the order of the file.  The chunks of a plane
+// that is not yet next in the file are spooled to a temporary file beside
+// it, so only the piece being compressed is held in memory.
+template <typename TImage>
+class CompressedComponentFileWriter
+{
+public:
+  using PixelType = typename TImage::PixelType;
+
+  // Write the header of the file for the largest possible region of the
+  // image, with numberOfPlanes planes when it is positive.
+  CompressedComponentFileWriter(const std::string & fileName,
+                                const TImage *      image,
+                                unsigned int        numberOfPlanes,
+                                int                 compressionLevel,
+                                WriterThreadPool &  writerPool)
+    : m_FileName(fileName)
+    , m_File(fileName, std::ios::binary)
+    , m_PlaneSize(image->GetLargestPossibleRegion().GetNumberOfPixels())
+    , m_PixelsWritten(std::max(1u, numberOfPlanes), 0)
+    , m_Spools(std::max(1u, numberOfPlanes))
+    , m_CompressionLevel(compressionLevel)
+    , m_WriterPool(writerPool)
+  {
+    // The size of the data is only known once it is written; a placeholder
+    // of fixed width is overwritten then.
+    std::ostringstream header;
+    WriteMetaImageHeader(header, image, numberOfPlanes, std::string(SizeFieldWidth, '0'));
+    header << "ElementDataFile = LOCAL\n";
+    const std::string headerText = header.str();
+    m_SizeFieldPosition = headerText.find("CompressedDataSize = ") + std::string("CompressedDataSize = ").size();
+    m_File << headerText;
+
+    // zlib header: deflate with a 32K window, and the compression level.
+    const unsigned int compressionMethod = 0x78;
+    const unsigned int levelFlags = compressionLevel < 2 ? 0 : compressionLevel < 6 ? 1 : compressionLevel == 6 ? 2 : 3;
+    unsigned int       flags = levelFlags << 6;
+    flags += 31 - (compressionMethod * 256 + flags) % 31;
+    m_File.put(static_cast<char>(compressionMethod));
+    m_File.put(static_cast<char>(flags));
+    m_DataSize = 2;
+    if (!m_File)
+    {
+      throw std::runtime_error("Could not write " + m_FileName);
+    }
+  }
+
+  // Remove the spools left by a file that was not closed.
+  ~CompressedComponentFileWriter()
+  {
+    for (Spool & spool : m_Spools)
+    {
+      this->RemoveSpool(spool);
+    }
+  }
+
+  CompressedComponentFileWriter(const CompressedComponentFileWriter &) = delete;
+  CompressedComponentFileWriter &
+  operator=(const CompressedComponentFileWriter &) = delete;
+
+  // Compress the buffered region of the image into the file, or into a
+  // plane of a planar file.
+  void
+  Write(const TImage * piece, unsigned int plane = 0)
+  {
+    const auto *      bytes = reinterpret_cast<const Bytef *>(piece->GetBufferPointer());
+    const std::size_t numberOfBytes = piece->GetBufferedRegion().GetNumberOfPixels() * sizeof(PixelType);
+    const std::size_t numberOfChunks = (numberOfBytes + ChunkSize - 1) / ChunkSize;
+    std::vector<Chunk> chunks(numberOfChunks);
+    m_WriterPool.ParallelFor(numberOfChunks, [&](std::size_t i) {
+      const std::size_t offset = i * ChunkSize;
+      this->Compress(bytes + offset, std::min(ChunkSize, numberOfBytes - offset), chunks[i]);
+    });
+
+    for (const Chunk & chunk : chunks)
+    {
+      if (plane == m_Plane)
+      {
+        this->Append(chunk);
+      }
+      else
+      {
+        this->SpoolChunk(m_Spools[plane], plane, chunk);
+      }
+    }
+    m_PixelsWritten[plane] += piece->GetBufferedRegion().GetNumberOfPixels();
+    // Move on to the planes that are next in the file, joining the chunks
+    // spooled for them so far.
+    while (m_Plane < m_PixelsWritten.size() && m_PixelsWritten[m_Plane] >= m_PlaneSize)
+    {
+      if (++m_Plane < m_Spools.size())
+      {
+        this->AppendSpool(m_Spools[m_Plane]);
+      }
+    }
+  }
+
+  // End the zlib stream and record its size.
+  void
+  Close()
+  {
+    if (m_Plane < m_PixelsWritten.size())
+    {
+      throw std::runtime_error("Not all of " + m_FileName + " was written.");
+    }
+    // An empty final block with fixed codes, then the Adler-32 checksum.
+    const unsigned char trailer[] = { 0x03,
+                                      0x00,
+                                      static_cast<unsigned char>(m_Adler >> 24),
+                                      static_cast<unsigned char>(m_Adler >> 16),
+                                      static_cast<unsigned char>(m_Adler >> 8),
+                                      static_cast<unsigned char>(m_Adler) };
+    m_File.write(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+    m_DataSize += sizeof(trailer);
+
+    std::ostringstream size;
+    size << std::setw(SizeFieldWidth) << std::setfill('0') << m_DataSize;
+    m_File.seekp(static_cast<std::streamoff>(m_SizeFieldPosition));
+    m_File << size.str();
+    m_File.close();
+    if (!m_File)
+    {
+      throw std::runtime_error("Could not write " + m_FileName);
+    }
+  }
+
+private:
+  static constexpr std::size_t ChunkSize = 1 << 20;
+  static constexpr std::size_t SizeFieldWidth = 20;
+
+  struct Chunk
+  {
+    std::vector<Bytef> data;
+    uLong              adler{ 0 };
+    uLong              size{ 0 };
+  };
+
+  // The compressed data of a plane written ahead of the file, and the
+  // checksum and size of its uncompressed data.
+  struct Spool
+  {
+    std::string  fileName;
+    std::fstream file;
+    uLong        adler{ 1 };
+    z_off_t      size{ 0 };
+  };
+
+  void
+  Compress(const Bytef * bytes, std::size_t numberOfBytes, Chunk & chunk) const
+  {
+    z_stream stream{};
+    if (deflateInit2(&stream, m_CompressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      throw std::runtime_error("Could not initialize the compression of " + m_FileName);
+    }
+    // Room for the sync flush marker beyond the bound of the deflated data.
+    chunk.data.resize(deflateBound(&stream, static_cast<uLong>(numberOfBytes)) + 16);
+    stream.next_in = const_cast<Bytef *>(bytes);
+    stream.avail_in = static_cast<uInt>(numberOfBytes);
+    stream.next_out = chunk.data.data();
+    stream.avail_out = static_cast<uInt>(chunk.data.size());
+    const int result = deflate(&stream, Z_SYNC_FLUSH);
+    const bool complete = result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+    chunk.data.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (!complete)
+    {
+      throw std::runtime_error("Could not compress " + m_FileName);
+    }
+    chunk.adler = adler32(adler32(0L, Z_NULL, 0), bytes, static_cast<uInt>(numberOfBytes));
+    chunk.size = static_cast<uLong>(numberOfBytes);
+  }
+
+  void
+  Append(const Chunk & chunk)
+  {
+    m_File.write(reinterpret_cast<const char *>(chunk.data.data()), static_cast<std::streamsize>(chunk.data.size()));
+    if (!m_File)
+    {
+      throw std::runtime_error("Could not write " + m_FileName);
+    }
+    m_DataSize += chunk.data.size();
+    m_Adler = adler32_combine(m_Adler, chunk.adler, static_cast<z_off_t>(chunk.size));
+  }
+
+  void
+  SpoolChunk(Spool & spool, unsigned int plane, const Chunk & chunk)
+  {
+    if (!spool.file.is_open())
+    {
+      spool.fileName = m_FileName + ".plane" + std::to_string(plane) + ".tmp";
+      spool.file.open(spool.fileName, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    spool.file.write(reinterpret_cast<const char *>(chunk.data.data()),
+                     static_cast<std::streamsize>(chunk.data.size()));
+    if (!spool.file)
+    {
+      throw std::runtime_error("Could not write " + spool.fileName);
+    }
+    spool.adler = adler32_combine(spool.adler, chunk.adler, static_cast<z_off_t>(chunk.size));
+    spool.size += static_cast<z_off_t>(chunk.size);
+  }
+
+  // Copy the spooled chunks of a plane into the file, and remove the spool.
+  void
+  AppendSpool(Spool & spool)
+  {
+    if (!spool.file.is_open())
+    {
+      return;
+    }
+    spool.file.seekg(0);
+    std::vector<char> buffer(ChunkSize);
+    while (spool.file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || spool.file.gcount() > 0)
+    {
+      m_File.write(buffer.data(), spool.file.gcount());
+      m_DataSize += static_cast<std::size_t>(spool.file.gcount());
+    }
+    if (!m_File)
+    {
+      throw std::runtime_error("Could not write " + m_FileName);
+    }
+    m_Adler = adler32_combine(m_Adler, spool.adler, spool.size);
+    this->RemoveSpool(spool);
+  }
+
+  void
+  RemoveSpool(Spool & spool)
+  {
+    if (spool.file.is_open())
+    {
+      spool.file.close();
+      std::remove(spool.fileName.c_str());
+    }
+  }
+
+  std::string                     m_FileName;
+  std::ofstream                   m_File;
+  std::size_t                     m_SizeFieldPosition{ 0 };
+  itk::SizeValueType              m_PlaneSize;
+  std::vector<itk::SizeValueType> m_PixelsWritten;
+  std::vector<Spool>              m_Spools;
+  std::size_t                     m_Plane{ 0 };
+  int                             m_CompressionLevel;
+  WriterThreadPool &              m_WriterPool;
+  std::size_t                     m_DataSize{ 0 };
+  uLong                           m_Adler{ 1 };
+};
+
+
+#ifdef SPLIT_COMPONENTS_MAPPED_FILES
+// A MetaImage header and raw data file for an image, with the data file
+// mapped into memory.  The components are split straight into the mapping,
+// so the data reaches the page cache without a heap buffer or a copy.
+template <typename TImage>
+class MappedComponentFile
+{
+public:
+  static constexpr unsigned int Dimension = TImage::ImageDimension;
+  using PixelType = typename TImage::PixelType;
+  using RegionType = typename TImage::RegionType;
+  using PixelContainerType = typename TImage::PixelContainer;
+
+  // Write the header and map a data file for the largest possible region of
+  // the image, or for numberOfPlanes planes of it, as with
+  // ComponentFileWriter, when it is positive.
+  MappedComponentFile(const std::string & headerFileName, const TImage * image, unsigned int numberOfPlanes = 0)
+    : m_LargestRegion(image->GetLargestPossibleRegion())
+  {
+    const std::string dataFileName = itksys::SystemTools::GetFilenameWithoutLastExtension(headerFileName) + ".raw";
+    const std::string dataPath = itksys::SystemTools::GetFilenamePath(headerFileName);
+
+    std::ofstream header(headerFileName);
+    if (!header)
+    {
+      throw std::runtime_error("Could not write " + headerFileName);
+    }
+    WriteMetaImageHeader(header, image, numberOfPlanes, "");
+    header << "ElementDataFile = " << dataFileName << '\n';
+    if (!header)
+    {
+      throw std::runtime_error("Could not write " + headerFileName);
+    }
+
+    const std::string dataFile = dataPath.empty() ? dataFileName : dataPath + '/' + dataFileName;
+    m_Size = m_LargestRegion.GetNumberOfPixels() * std::max(1u, numberOfPlanes) * sizeof(PixelType);
+    m_FileDescriptor = open(dataFile.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_FileDescriptor < 0 || ftruncate(m_FileDescriptor, static_cast<off_t>(m_Size)) != 0)
+    {
+      this->Close();
+      throw std::runtime_error("Could not create " + dataFile);
+    }
+    void * mapping = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, m_FileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+      this->Close();
+      throw std::runtime_error("Could not map " + dataFile);
+    }
+    m_Data = static_cast<PixelType *>(mapping);
+  }
+
+  MappedComponentFile(const MappedComponentFile &) = delete;
+  MappedComponentFile &
+  operator=(const MappedComponentFile &) = delete;
+
+  ~MappedComponentFile() { this->Close(); }
+
+  // A container over the part of the mapping that holds a piece, or the
+  // piece of a plane, which must be contiguous in the file.
+  typename PixelContainerType::Pointer
+  GetPixelContainer(const RegionType & piece, unsigned int plane = 0) const
+  {
+    itk::SizeValueType offset = plane * m_LargestRegion.GetNumberOfPixels();
+    itk::SizeValueType stride = 1;
+    bool               contiguous = true;
+    bool               partial = false;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      offset += static_cast<itk::SizeValueType>(piece.GetIndex(i) - m_LargestRegion.GetIndex(i)) * stride;
+      stride *= m_LargestRegion.GetSize(i);
+      contiguous = contiguous && (!partial || piece.GetSize(i) == 1);
+      partial = partial || piece.GetSize(i) != m_LargestRegion.GetSize(i);
+    }
+    if (!contiguous)
+    {
+      throw std::runtime_error("A stream piece is not contiguous in the mapped output file.");
+    }
+    auto container = PixelContainerType::New();
+    container->SetImportPointer(m_Data + offset, piece.GetNumberOfPixels(), false);
+    return container;
+  }
+
+private:
+  void
+  Close()
+  {
+    if (m_Data)
+    {
+      munmap(m_Data, m_Size);
+      m_Data = nullptr;
+    }
+    if (m_FileDescriptor >= 0)
+    {
+      close(m_FileDescriptor);
+      m_FileDescriptor = -1;
+    }
+  }
+
+  RegionType  m_LargestRegion;
+  std::size_t m_Size{ 0 };
+  int         m_FileDescriptor{ -1 };
+  PixelType * m_Data{ nullptr };
+};
+#endif
+
+
+// Number of pieces to stream an image through in, so each piece fits the
+// memory budget; 10 without a budget.
+unsigned int
+StreamDivisions(itk::SizeValueType numberOfPixels, std::size_t bytesPerPixel, std::size_t maxMemory)
+{
+  if (maxMemory == 0)
+  {
+    return 10;
+  }
+  const itk::SizeValueType pixelsPerPiece = std::max<itk::SizeValueType>(1, maxMemory / bytesPerPixel);
+  const itk::SizeValueType divisions = (numberOfPixels + pixelsPerPiece - 1) / pixelsPerPiece;
+  return static_cast<unsigned int>(
+    std::min<itk::SizeValueType>(std::max<itk::SizeValueType>(1, divisions), std::numeric_limits<unsigned int>::max()));
+}
+
+
+// The input is read as a VectorImage, whatever its number of components, and
+// split with the filter's scanline kernels, which pick their typed fast paths
+// for 2, 3, 4 and 6 components by the stride of the pixels at run time.
+template <class TPixel, unsigned int TDimension>
+void
+ExtractComponents(const Args & args)
+{
+  using InputImageType = itk::VectorImage<TPixel, TDimension>;
+  using OutputImageType = itk::Image<TPixel, TDimension>;
+  using RegionType = typename OutputImageType::RegionType;
+
+  using ReaderType = itk::ImageFileReader<InputImageType>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(args.inputImage);
+  reader->UpdateOutputInformation();
+  const RegionType   largestRegion = reader->GetOutput()->GetLargestPossibleRegion();
+  const unsigned int numberOfComponents = reader->GetOutput()->GetNumberOfComponentsPerPixel();
+  const std::size_t  inputPixelBytes = numberOfComponents * sizeof(TPixel);
+
+  // The components are selected below, so the components mask of one is not
+  // used.
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 1>;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(reader->GetOutput());
+
+  // Only the selected components are allocated, generated and written.
+  const std::vector<unsigned int> components = SelectedComponents(args, numberOfComponents);
+  filter->SetSelectedComponents(components);
+  filter->SetFirstTouchOutputs(args.firstTouch);
+  // The streamed pieces are split into the buffers of the previous piece,
+  // unless their pages are to be placed anew.
+  filter->SetReuseOutputBuffers(!args.firstTouch);
+
+  // Statistics are computed in the split, and merged over the pieces.
+  const bool computeStatistics = !args.statisticsFile.empty();
+  if (computeStatistics)
+  {
+    filter->ComputeStatisticsOn();
+    // Without a range, floating point pixels keep the default of no
+    // histogram.
+    if (args.histogramRangeSet)
+    {
+      filter->SetHistogramNumberOfBins(args.histogramBins);
+      filter->SetHistogramLowerBound(args.histogramLowerBound);
+      filter->SetHistogramUpperBound(args.histogramUpperBound);
+    }
+    else if (std::numeric_limits<TPixel>::is_integer)
+    {
+      filter->SetHistogramNumberOfBins(args.histogramBins);
+    }
+  }
+  std::vector<itk::ComponentStatistics> componentStatistics(components.size());
+
+  // One writer per selected component, or a single writer of a planar file
+  // with --planar, where the selected components are the planes in order.
+  // Each writer pastes the stream pieces it is given into its file, so the
+  // files are built up piece by piece.  With --mmap, the components are
+  // instead split straight into their mapped files, and there is nothing
+  // left to write.
+  filter->UpdateOutputInformation();
+  WriterThreadPool                                                              writerPool(WriterThreads(args));
+  std::vector<ComponentFileWriter<OutputImageType>>                             writers;
+  std::vector<std::unique_ptr<CompressedComponentFileWriter<OutputImageType>>> compressedWriters;
+#ifdef SPLIT_COMPONENTS_MAPPED_FILES
+  std::vector<std::unique_ptr<MappedComponentFile<OutputImageType>>> mappedFiles;
+#else
+  if (args.mapOutput)
+  {
+    throw std::runtime_error("Memory mapped output files are not supported on this platform.");
+  }
+#endif
+  const char * const       extension = args.mapOutput ? ".mhd" : ".mha";
+  const std::size_t        componentsPerFile = args.planar ? components.size() : 1;
+  const unsigned int       numberOfPlanes = args.planar ? static_cast<unsigned int>(components.size()) : 0;
+  std::vector<std::string> fileNames;
+  std::vector<std::string> outputFiles;
+  for (std::size_t i = 0; i < components.size(); ++i)
+  {
+    if (i % componentsPerFile == 0)
+    {
+      fileNames.push_back(args.planar ? args.outputPrefix + "Components" + extension
+                                      : ComponentFileName(args.outputPrefix, components[i], extension));
+      const OutputImageType * output = filter->GetOutput(components[i]);
+#ifdef SPLIT_COMPONENTS_MAPPED_FILES
+      if (args.mapOutput)
+      {
+        mappedFiles.push_back(
+          std::make_unique<MappedComponentFile<OutputImageType>>(fileNames.back(), output, numberOfPlanes));
+      }
+#endif
+      if (args.compress)
+      {
+        compressedWriters.push_back(std::make_unique<CompressedComponentFileWriter<OutputImageType>>(
+          fileNames.back(), output, numberOfPlanes, args.compressionLevel, writerPool));
+      }
+      else if (!args.mapOutput)
+      {
+        // Pasting requires a fresh file.
+        itksys::SystemTools::RemoveFile(fileNames.back());
+        writers.emplace_back(fileNames.back(), output, numberOfPlanes);
+      }
+    }
+    outputFiles.push_back(fileNames.back());
+  }
+  // Compressed files are written one at a time, each compressing its chunks
+  // on all the writer threads.
+  const std::size_t  numberOfFilesToWrite = writers.size() + compressedWriters.size();
+  const unsigned int numberOfWriterThreads = args.compress ? 1 : writerPool.GetNumberOfThreads();
+
+  // Time the reader and the filter between their start and end events.
+  itk::TimeProbe readProbe;
+  itk::TimeProbe splitProbe;
+  if (args.stats)
+  {
+    reader->AddObserver(itk::StartEvent(), [&readProbe](const itk::EventObject &) { readProbe.Start(); });
+    reader->AddObserver(itk::EndEvent(), [&readProbe](const itk::EventObject &) { readProbe.Stop(); });
+    filter->AddObserver(itk::StartEvent(), [&splitProbe](const itk::EventObject &) { splitProbe.Start(); });
+    filter->AddObserver(itk::EndEvent(), [&splitProbe](const itk::EventObject &) { splitProbe.Stop(); });
+  }
+  std::vector<double> writeTimes(numberOfFilesToWrite, 0.0);
+  double              splitWorkTime = 0.0;
+  double              slowestSlabTime = 0.0;
+  unsigned int        numberOfSlabs = 0;
+  itk::TimeProbe      totalProbe;
+  totalProbe.Start();
+
+  // Stream the input once.  Each piece is read and split on this thread,
+  // generating the piece on every selected output, and then written to all
+  // the component files at once by the writer threads.
+  const unsigned int numberOfStreamDivisions = StreamDivisions(largestRegion.GetNumberOfPixels(),
+                                                               inputPixelBytes + components.size() * sizeof(TPixel),
+                                                               args.maxMemory);
+  const auto         splitter = itk::ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(largestRegion, numberOfStreamDivisions);
+  if (args.maxMemory > 0)
+  {
+    // A streamed read only reads the requested slab from the file; other
+    // ImageIOs read the whole input, and then only the split is bounded.
+    if (!reader->GetImageIO()->CanStreamRead())
+    {
+      std::cerr << "Warning: " << reader->GetImageIO()->GetNameOfClass() << " cannot stream " << args.inputImage
+                << "; the whole input is read into memory." << std::endl;
+    }
+    if (numberOfPieces < numberOfStreamDivisions)
+    {
+      std::cerr << "Warning: " << args.inputImage << " can only be split into " << numberOfPieces
+                << " pieces, which exceed the memory budget." << std::endl;
+    }
+  }
+  for (unsigned int piece = 0; piece < numberOfPieces; ++piece)
+  {
+    RegionType pieceRegion = largestRegion;
+    splitter->GetSplit(piece, numberOfPieces, pieceRegion);
+#ifdef SPLIT_COMPONENTS_MAPPED_FILES
+    for (std::size_t i = 0; i < mappedFiles.size() * componentsPerFile; ++i)
+    {
+      const MappedComponentFile<OutputImageType> & mappedFile = *mappedFiles[i / componentsPerFile];
+      filter->SetOutputPixelContainer(
+        components[i], mappedFile.GetPixelContainer(pieceRegion, static_cast<unsigned int>(i % componentsPerFile)));
+    }
+#endif
+    OutputImageType * firstOutput = filter->GetOutput(components.front());
+    firstOutput->SetRequestedRegion(pieceRegion);
+    firstOutput->Update();
+
+    std::vector<const OutputImageType *> pieces;
+    for (const unsigned int component : components)
+    {
+      pieces.push_back(filter->GetOutput(component));
+    }
+    writerPool.ParallelFor(numberOfFilesToWrite, numberOfWriterThreads, [&](std::size_t file) {
+      itk::TimeProbe writeProbe;
+      writeProbe.Start();
+      for (std::size_t plane = 0; plane < componentsPerFile; ++plane)
+      {
+        const OutputImageType * planePiece = pieces[file * componentsPerFile + plane];
+        if (args.compress)
+        {
+          compressedWriters[file]->Write(planePiece, static_cast<unsigned int>(plane));
+        }
+        else
+        {
+          writers[file].Write(planePiece, static_cast<unsigned int>(plane));
+        }
+      }
+      writeProbe.Stop();
+      writeTimes[file] += writeProbe.GetTotal();
+    });
+    splitWorkTime += filter->GetElapsedTime();
+    numberOfSlabs += filter->GetNumberOfExecutedSlabs();
+    for (const double slabTime : filter->GetSlabTimes())
+    {
+      slowestSlabTime = std::max(slowestSlabTime, slabTime);
+    }
+    if (computeStatistics)
+    {
+      for (std::size_t i = 0; i < components.size(); ++i)
+      {
+        componentStatistics[i].Merge(filter->GetComponentStatistics(components[i]));
+      }
+    }
+  }
+  for (std::size_t file = 0; file < compressedWriters.size(); ++file)
+  {
+    itk::TimeProbe closeProbe;
+    closeProbe.Start();
+    compressedWriters[file]->Close();
+    closeProbe.Stop();
+    writeTimes[file] += closeProbe.GetTotal();
+  }
+  totalProbe.Stop();
+
+  if (computeStatistics)
+  {
+    WriteStatistics(args.statisticsFile, args.inputImage, components, outputFiles, componentStatistics);
+  }
+
+  if (args.stats)
+  {
+    const double numberOfPixels = largestRegion.GetNumberOfPixels();
+    const double inputBytes = numberOfPixels * inputPixelBytes;
+    const double componentBytes = numberOfPixels * sizeof(TPixel);
+    const auto   megabytesPerSecond = [](double bytes, double seconds) {
+      return seconds > 0.0 ? bytes / seconds / 1.0e6 : 0.0;
+    };
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "read:  " << readProbe.GetTotal() << " s, " << megabytesPerSecond(inputBytes, readProbe.GetTotal())
+              << " MB/s, " << args.inputImage << std::endl;
+    std::cout << "split: " << splitProbe.GetTotal() << " s, "
+              << megabytesPerSecond(inputBytes + componentBytes * components.size(), splitProbe.GetTotal())
+              << " MB/s, " << splitWorkTime << " s in " << numberOfSlabs << " slabs, slowest "
+              << slowestSlabTime << " s" << std::endl;
+    for (std::size_t i = 0; i < numberOfFilesToWrite; ++i)
+    {
+      std::cout << "write: " << writeTimes[i] << " s, "
+                << megabytesPerSecond(componentBytes * componentsPerFile, writeTimes[i]) << " MB/s, " << fileNames[i]
+                << std::endl;
+    }
+    std::cout << "total: " << totalProbe.GetTotal() << " s, "
+              << megabytesPerSecond(inputBytes, totalProbe.GetTotal()) << " MB/s of input" << std::endl;
+  }
+}
+
+// Split a scalar image along the axis given with --axis into an image of one
+// dimension less per slice.  The slices are selected like the components,
+// and written to <prefix>Slice<i>.mha concurrently.  Along the slowest axis
+// the slices are views of the input, so only the files are written.
+template <class TPixel, unsigned int TDimension>
 void
-ExtractComponents(const Args & args)
+ExtractSlices(const Args & args)
 {
-  using VectorType = itk::Vector<TPixel, TComponents>;
-  using InputImageType = itk::Image<VectorType, TDimension>;
-  using OutputImageType = itk::Image<TPixel, TDimension>;
+  using InputImageType = itk::Image<TPixel, TDimension>;
+  using OutputImageType = itk::Image<TPixel, TDimension - 1>;
+
+  if (static_cast<unsigned int>(args.axis) >= TDimension)
+  {
+    std::ostringstream message;
+    message << "Axis " << args.axis << " requested, but " << args.inputImage << " has " << TDimension
+            << " dimensions.";
+    throw std::runtime_error(message.str());
+  }
 
   using ReaderType = itk::ImageFileReader<InputImageType>;
   typename ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileName(args.inputImage);
 
-  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, TComponents>;
+  using FilterType = itk::SplitAxisImageFilter<InputImageType, OutputImageType>;
   typename FilterType::Pointer filter = FilterType::New();
   filter->SetInput(reader->GetOutput());
+  filter->SetAxis(static_cast<unsigned int>(args.axis));
+  filter->UpdateOutputInformation();
+  const std::vector<unsigned int> slices = SelectedComponents(args, filter->GetNumberOfSlices());
+  filter->SetSelectedSlices(slices);
 
-  using WriterType = itk::ImageFileWriter<OutputImageType>;
-  typename WriterType::Pointer writer = WriterType::New();
-  writer->SetNumberOfStreamDivisions(10);
+  itk::TimeProbe splitProbe;
+  splitProbe.Start();
+  filter->GetOutput(slices.front())->Update();
+  splitProbe.Stop();
 
-  std::ostringstream ostr;
-  for (unsigned int i = 0; i < TComponents; ++i)
+  std::vector<double> writeTimes(slices.size(), 0.0);
+  WriterThreadPool writerPool(WriterThreads(args));
+  writerPool.ParallelFor(slices.size(), [&](std::size_t i) {
+    itk::TimeProbe writeProbe;
+    writeProbe.Start();
+    std::ostringstream fileName;
+    fileName << args.outputPrefix << "Slice" << slices[i] << ".mha";
+    // Pasting requires a fresh file.
+    itksys::SystemTools::RemoveFile(fileName.str());
+    const OutputImageType *              slice = filter->GetOutput(slices[i]);
+    ComponentFileWriter<OutputImageType> writer(fileName.str(), slice);
+    writer.Write(slice);
+    writeProbe.Stop();
+    writeTimes[i] = writeProbe.GetTotal();
+  });
+
+  if (args.stats)
   {
-    ostr.str("");
-    ostr << args.outputPrefix << "Component" << i << ".mha";
-    writer->SetInput(filter->GetOutput(i));
-    writer->SetFileName(ostr.str());
-    writer->Update();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "read and split: " << splitProbe.GetTotal() << " s, " << args.inputImage << std::endl;
+    for (std::size_t i = 0; i < slices.size(); ++i)
+    {
+      std::cout << "write: " << writeTimes[i] << " s, slice " << slices[i] << std::endl;
+    }
   }
 }
 
 
-int
-main(int argc, char * argv[])
+// Look up the ImageIO of an image and read its information.
+itk::ImageIOBase::Pointer
+ReadImageInformation(const std::string & fileName)
 {
-  try
+  const itk::ImageIOBase::Pointer imageIO = CreateImageIO(fileName, itk::ImageIOFactory::ReadMode);
+  if (!imageIO)
   {
-    Args args(argc, argv);
+    throw std::runtime_error("No ImageIO found for " + fileName);
+  }
+  imageIO->SetFileName(fileName);
+  imageIO->ReadImageInformation();
+  return imageIO;
+}
 
-    itk::ImageIOBase::Pointer imageIO =
-      itk::ImageIOFactory::CreateImageIO(args.inputImage.c_str(), itk::ImageIOFactory::ReadMode);
-    if (!imageIO)
-    {
-      throw std::runtime_error(std::string("No ImageIO found for ") + args.inputImage);
-    }
-    imageIO->SetFileName(args.inputImage.c_str());
-    imageIO->ReadImageInformation();
 
-    // Find out the pixel type of the image in file
-    using ScalarComponentType = itk::ImageIOBase::IOComponentType;
-    ScalarComponentType componentType = imageIO->GetComponentType();
+// Call function(component, dimension) with a value of the component type of
+// the image, and the dimension of the image as an std::integral_constant, to
+// instantiate it for the image.
+template <typename TFunction>
+void
+DispatchPixelType(const itk::ImageIOBase * imageIO, const TFunction & function)
+{
+  const unsigned int dimension = imageIO->GetNumberOfDimensions();
+  if (dimension < 2 || dimension > 4)
+  {
+    std::ostringstream message;
+    message << imageIO->GetFileName() << " has " << dimension << " dimensions; only 2, 3 and 4 are supported.";
+    throw std::runtime_error(message.str());
+  }
 
-    const unsigned int dimension = imageIO->GetNumberOfDimensions();
-    if (!(dimension == 2 || dimension == 3))
+  const auto dispatchDimension = [&function, dimension](auto component) {
+    switch (dimension)
     {
-      std::logic_error("Only images of dimension 2 and 3 are supported.");
+      case 2:
+        function(component, std::integral_constant<unsigned int, 2>());
+        break;
+      case 3:
+        function(component, std::integral_constant<unsigned int, 3>());
+        break;
+      default:
+        function(component, std::integral_constant<unsigned int, 4>());
+        break;
     }
-
-    const unsigned int components = imageIO->GetNumberOfComponents();
-
-    // So in hindsight using VectorImageToImageAdaptor would have been more
-    // elegant for this case.
-    switch (componentType)
-    {
+  };
+  switch (imageIO->GetComponentType())
+  {
 #ifdef USE_UCHAR
-      case itk::ImageIOBase::UCHAR:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned char, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned char, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned char, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned char, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned char, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned char, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned char, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned char, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned char, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned char, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned char, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned char, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_UCHAR
+    case itk::ImageIOBase::UCHAR:
+      dispatchDimension(static_cast<unsigned char>(0));
+      break;
+#endif
 #ifdef USE_CHAR
-      case itk::ImageIOBase::CHAR:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<char, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<char, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<char, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<char, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<char, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<char, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<char, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<char, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<char, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<char, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<char, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<char, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_CHAR
+    case itk::ImageIOBase::CHAR:
+      dispatchDimension(static_cast<char>(0));
+      break;
+#endif
 #ifdef USE_USHORT
-      case itk::ImageIOBase::USHORT:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned short, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned short, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned short, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned short, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned short, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned short, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned short, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned short, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned short, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned short, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned short, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned short, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_USHORT
+    case itk::ImageIOBase::USHORT:
+      dispatchDimension(static_cast<unsigned short>(0));
+      break;
+#endif
 #ifdef USE_SHORT
-      case itk::ImageIOBase::SHORT:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<short, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<short, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<short, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<short, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<short, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<short, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<short, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<short, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<short, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<short, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<short, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<short, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_SHORT
+    case itk::ImageIOBase::SHORT:
+      dispatchDimension(static_cast<short>(0));
+      break;
+#endif
 #ifdef USE_UINT
-      case itk::ImageIOBase::UINT:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned int, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned int, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned int, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned int, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned int, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned int, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned int, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned int, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned int, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned int, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned int, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned int, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_UINT
+    case itk::ImageIOBase::UINT:
+      dispatchDimension(static_cast<unsigned int>(0));
+      break;
+#endif
 #ifdef USE_INT
-      case itk::ImageIOBase::INT:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<int, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<int, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<int, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<int, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<int, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<int, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<int, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<int, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<int, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<int, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<int, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<int, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_INT
+    case itk::ImageIOBase::INT:
+      dispatchDimension(static_cast<int>(0));
+      break;
+#endif
 #ifdef USE_ULONG
-      case itk::ImageIOBase::ULONG:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned long, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned long, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned long, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned long, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned long, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned long, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<unsigned long, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<unsigned long, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<unsigned long, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<unsigned long, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<unsigned long, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<unsigned long, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_ULONG
+    case itk::ImageIOBase::ULONG:
+      dispatchDimension(static_cast<unsigned long>(0));
+      break;
+#endif
 #ifdef USE_LONG
-      case itk::ImageIOBase::LONG:
-      {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<long, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<long, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<long, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<long, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<long, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<long, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<long, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<long, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<long, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<long, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<long, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<long, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
-      }
-#endif // USE_LONG
+    case itk::ImageIOBase::LONG:
+      dispatchDimension(static_cast<long>(0));
+      break;
+#endif
 #ifdef USE_FLOAT
-      case itk::ImageIOBase::FLOAT:
-      {
-        if (dimension == 2)
+    case itk::ImageIOBase::FLOAT:
+      dispatchDimension(static_cast<float>(0));
+      break;
+#endif
+#ifdef USE_DOUBLE
+    case itk::ImageIOBase::DOUBLE:
+      dispatchDimension(static_cast<double>(0));
+      break;
+#endif
+    default:
+    {
+      itk::ExceptionObject ex;
+      ex.SetDescription("The file uses a pixel support not supported at this time.");
+      throw ex;
+    }
+  }
+}
+
+
+// A queue between two stages of the batch mode.  It holds at most a given
+// number of items, so a fast stage waits for a slow one instead of piling up
+// images.
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(std::size_t capacity)
+    : m_Capacity(std::max<std::size_t>(1, capacity))
+  {}
+
+  // Add an item once there is room for it.
+  void
+  Push(T item)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_NotFull.wait(lock, [this] { return m_Items.size() < m_Capacity; });
+    m_Items.push_back(std::move(item));
+    m_NotEmpty.notify_one();
+  }
+
+  // No more items will be pushed.
+  void
+  Close()
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Closed = true;
+    m_NotEmpty.notify_all();
+  }
+
+  // Take the next item, waiting for one.  False once the queue is closed and
+  // empty.
+  bool
+  Pop(T & item)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_NotEmpty.wait(lock, [this] { return !m_Items.empty() || m_Closed; });
+    if (m_Items.empty())
+    {
+      return false;
+    }
+    item = std::move(m_Items.front());
+    m_Items.pop_front();
+    m_NotFull.notify_one();
+    return true;
+  }
+
+private:
+  const std::size_t       m_Capacity;
+  std::deque<T>           m_Items;
+  bool                    m_Closed{ false };
+  std::mutex              m_Mutex;
+  std::condition_variable m_NotFull;
+  std::condition_variable m_NotEmpty;
+};
+
+
+// An image of the batch manifest on its way through the stages.  The read
+// stage sets split, which holds the input image; the split stage replaces it
+// with write, which holds the components.
+struct BatchJob
+{
+  std::string                                              inputImage;
+  std::string                                              outputPrefix;
+  std::function<std::function<void(WriterThreadPool &)>()> split;
+  std::function<void(WriterThreadPool &)>                  write;
+  std::exception_ptr                                       error;
+  std::array<double, 3>                                    stageTimes{};
+};
+
+
+// Read the input image of a batch job, and set up its split and write
+// stages for its pixel type.
+template <class TPixel, unsigned int TDimension>
+void
+ReadBatchJob(const Args & args, itk::ImageIOBase * imageIO, BatchJob & job)
+{
+  using InputImageType = itk::VectorImage<TPixel, TDimension>;
+  using OutputImageType = itk::Image<TPixel, TDimension>;
+
+  using ReaderType = itk::ImageFileReader<InputImageType>;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(job.inputImage);
+  reader->SetImageIO(imageIO);
+  reader->Update();
+  typename InputImageType::Pointer input = reader->GetOutput();
+  input->DisconnectPipeline();
+
+  job.split = [&args, input, outputPrefix = job.outputPrefix]() -> std::function<void(WriterThreadPool &)> {
+    using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 1>;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    const std::vector<unsigned int> components = SelectedComponents(args, input->GetNumberOfComponentsPerPixel());
+    filter->SetSelectedComponents(components);
+    filter->SetFirstTouchOutputs(args.firstTouch);
+    filter->Update();
+
+    std::vector<typename OutputImageType::Pointer> outputs;
+    for (const unsigned int component : components)
+    {
+      outputs.push_back(filter->GetOutput(component));
+      outputs.back()->DisconnectPipeline();
+    }
+    return [&args, components, outputs, outputPrefix](WriterThreadPool & writerPool) {
+      // A file per component, or a planar file, written as in
+      // ExtractComponents.
+      const std::size_t  componentsPerFile = args.planar ? outputs.size() : 1;
+      const unsigned int numberOfPlanes = args.planar ? static_cast<unsigned int>(outputs.size()) : 0;
+      const unsigned int numberOfWriterThreads = args.compress ? 1 : writerPool.GetNumberOfThreads();
+      writerPool.ParallelFor(outputs.size() / componentsPerFile, numberOfWriterThreads, [&](std::size_t file) {
+        const std::size_t first = file * componentsPerFile;
+        const std::string fileName = args.planar ? outputPrefix + "Components.mha"
+                                                 : ComponentFileName(outputPrefix, components[first], ".mha");
+        itksys::SystemTools::RemoveFile(fileName);
+        if (args.compress)
         {
-          switch (components)
+          CompressedComponentFileWriter<OutputImageType> writer(
+            fileName, outputs[first], numberOfPlanes, args.compressionLevel, writerPool);
+          for (std::size_t plane = 0; plane < componentsPerFile; ++plane)
           {
-            case 1:
-            {
-              ExtractComponents<float, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<float, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<float, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<float, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<float, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<float, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
+            writer.Write(outputs[first + plane], static_cast<unsigned int>(plane));
           }
+          writer.Close();
         }
         else
         {
-          switch (components)
+          ComponentFileWriter<OutputImageType> writer(fileName, outputs[first], numberOfPlanes);
+          for (std::size_t plane = 0; plane < componentsPerFile; ++plane)
           {
-            case 1:
-            {
-              ExtractComponents<float, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<float, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<float, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<float, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<float, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<float, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
+            writer.Write(outputs[first + plane], static_cast<unsigned int>(plane));
           }
         }
-        break;
+      });
+    };
+  };
+}
+
+
+// The images of a batch manifest and their output prefixes.
+std::vector<BatchJob>
+ReadManifest(const std::string & fileName)
+{
+  std::ifstream manifest(fileName);
+  if (!manifest)
+  {
+    throw std::runtime_error("Could not read " + fileName);
+  }
+  std::vector<BatchJob> jobs;
+  std::string           line;
+  while (std::getline(manifest, line))
+  {
+    std::istringstream fields(line);
+    BatchJob           job;
+    if (!(fields >> job.inputImage) || job.inputImage[0] == '#')
+    {
+      continue;
+    }
+    if (!(fields >> job.outputPrefix))
+    {
+      job.outputPrefix = Args::DefaultOutputPrefix(job.inputImage);
+    }
+    jobs.push_back(std::move(job));
+  }
+  return jobs;
+}
+
+
+// Run a stage of a batch job, timing it and keeping its exception.
+template <typename TStage>
+void
+RunBatchStage(BatchJob & job, unsigned int stage, const TStage & run)
+{
+  if (job.error)
+  {
+    return;
+  }
+  itk::TimeProbe probe;
+  probe.Start();
+  try
+  {
+    run();
+  }
+  catch (...)
+  {
+    job.error = std::current_exception();
+  }
+  probe.Stop();
+  job.stageTimes[stage] = probe.GetTotal();
+}
+
+
+// Split the images of a manifest in one process.  A thread reads the images
+// and another splits them, while this thread writes the components, so
+// image k + 1 is read while image k is split and image k - 1 is written.
+// Queues of args.queueDepth images between the stages bound the memory.
+// This thread writes on a pool of --writer-threads threads kept for the
+// whole batch, apart from the threads of the split.
+int
+RunBatch(const Args & args)
+{
+  std::vector<BatchJob> jobs = ReadManifest(args.inputImage);
+  itk::TimeProbe        totalProbe;
+  totalProbe.Start();
+
+  BoundedQueue<BatchJob> splitQueue(args.queueDepth);
+  BoundedQueue<BatchJob> writeQueue(args.queueDepth);
+
+  std::thread readThread([&]() {
+    for (BatchJob & job : jobs)
+    {
+      RunBatchStage(job, 0, [&]() {
+        const itk::ImageIOBase::Pointer imageIO = ReadImageInformation(job.inputImage);
+        DispatchPixelType(imageIO, [&](auto component, auto dimension) {
+          ReadBatchJob<decltype(component), decltype(dimension)::value>(args, imageIO, job);
+        });
+      });
+      splitQueue.Push(std::move(job));
+    }
+    splitQueue.Close();
+  });
+  std::thread splitThread([&]() {
+    BatchJob job;
+    while (splitQueue.Pop(job))
+    {
+      RunBatchStage(job, 1, [&]() { job.write = job.split(); });
+      // Release the input.
+      job.split = nullptr;
+      writeQueue.Push(std::move(job));
+    }
+    writeQueue.Close();
+  });
+
+  // The writer threads serve all the images of the batch.
+  WriterThreadPool writerPool(WriterThreads(args));
+  unsigned int     numberOfFailures = 0;
+  BatchJob         job;
+  while (writeQueue.Pop(job))
+  {
+    RunBatchStage(job, 2, [&]() { job.write(writerPool); });
+    job.write = nullptr;
+    if (job.error)
+    {
+      ++numberOfFailures;
+      try
+      {
+        std::rethrow_exception(job.error);
       }
-#endif // USE_FLOAT
-#ifdef USE_DOUBLE
-      case itk::ImageIOBase::DOUBLE:
+      catch (const std::exception & e)
       {
-        if (dimension == 2)
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<double, 2, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<double, 2, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<double, 2, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<double, 2, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<double, 2, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<double, 2, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        else
-        {
-          switch (components)
-          {
-            case 1:
-            {
-              ExtractComponents<double, 3, 1>(args);
-              break;
-            }
-            case 2:
-            {
-              ExtractComponents<double, 3, 2>(args);
-              break;
-            }
-            case 3:
-            {
-              ExtractComponents<double, 3, 3>(args);
-              break;
-            }
-            case 4:
-            {
-              ExtractComponents<double, 3, 4>(args);
-              break;
-            }
-            case 5:
-            {
-              ExtractComponents<double, 3, 5>(args);
-              break;
-            }
-            case 6:
-            {
-              ExtractComponents<double, 3, 6>(args);
-              break;
-            }
-            default:
-              throw std::logic_error("Only 1-6 components supported.");
-          }
-        }
-        break;
+        std::cerr << "Error: " << job.inputImage << ": " << e.what() << std::endl;
       }
-#endif // USE_DOUBLE
-      default:
+    }
+    else if (args.stats)
+    {
+      std::cout << std::fixed << std::setprecision(3) << job.inputImage << ": read " << job.stageTimes[0]
+                << " s, split " << job.stageTimes[1] << " s, write " << job.stageTimes[2] << " s" << std::endl;
+    }
+  }
+  readThread.join();
+  splitThread.join();
+  totalProbe.Stop();
+
+  if (args.stats)
+  {
+    std::cout << "batch: " << jobs.size() << " images in " << totalProbe.GetTotal() << " s, " << numberOfFailures
+              << " failed" << std::endl;
+  }
+  return numberOfFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int
+main(int argc, char * argv[])
+{
+  try
+  {
+    Args args(argc, argv);
+    if (args.batch)
+    {
+      return RunBatch(args);
+    }
+
+    const itk::ImageIOBase::Pointer imageIO = ReadImageInformation(args.inputImage);
+
+    if (args.axis >= 0)
+    {
+      if (imageIO->GetNumberOfComponents() != 1)
       {
-        itk::ExceptionObject ex;
-        ex.SetDescription("The file uses a pixel support not supported at this time.");
-        throw ex;
+        throw std::runtime_error("--axis splits scalar images, but " + args.inputImage + " has " +
+                                 std::to_string(imageIO->GetNumberOfComponents()) + " components per pixel.");
       }
-    } // end switch on pixel type
+      DispatchPixelType(imageIO, [&args](auto component, auto dimension) {
+        ExtractSlices<decltype(component), decltype(dimension)::value>(args);
+      });
+      return 0;
+    }
+
+    DispatchPixelType(imageIO, [&args](auto component, auto dimension) {
+      ExtractComponents<decltype(component), decltype(dimension)::value>(args);
+    });
   }
   catch (itk::ExceptionObject & err)
   {
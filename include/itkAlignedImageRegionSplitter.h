@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAlignedImageRegionSplitter_h
+#define itkAlignedImageRegionSplitter_h
+
+#include "itkImageRegionSplitterBase.h"
+#include "itkNumericTraits.h"
+#include "itkObjectFactory.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace itk
+{
+
+/** \class AlignedImageRegionSplitter
+ *
+ * \brief Split an image region into slabs that start at aligned addresses of
+ * a buffer that holds the region.
+ *
+ * The region is split along its slowest dimension with more than one index
+ * into slabs of whole rows, slices or volumes.  Where possible, every slab
+ * but the first starts on a multiple of the alignment, in pixels, of the
+ * buffer, e.g. on a cache line, so the work units that write adjacent slabs
+ * do not share one.  The alignment offset tells how many pixels past the
+ * previous aligned address the region starts.  When no slice starts
+ * aligned, or the aligned slices are further apart than a slab, as for most
+ * odd slice sizes, the slabs are balanced whole rows or slices that are not
+ * aligned, so there are still as many as requested.
+ *
+ * The slabs hold about the piece size in pixels, e.g. as many as fit the
+ * data of all the buffers in cache, but are made smaller when that leaves
+ * fewer slabs than requested, to keep every work unit busy.  Unlike other
+ * splitters, the number of slabs may exceed the requested number.
+ *
+ * \ingroup SplitComponents
+ */
+class AlignedImageRegionSplitter : public ImageRegionSplitterBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AlignedImageRegionSplitter);
+
+  /** Standard class type aliases. */
+  using Self = AlignedImageRegionSplitter;
+  using Superclass = ImageRegionSplitterBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkOverrideGetNameOfClassMacro(AlignedImageRegionSplitter);
+
+  /** Set/Get the alignment of the slabs, in pixels.  The default, 1, aligns
+   * them to whole rows only. */
+  itkSetClampMacro(Alignment, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(Alignment, SizeValueType);
+
+  /** Set/Get the number of pixels between the previous aligned address of
+   * the buffer and the start of the region.  The default is 0, a region
+   * that starts aligned. */
+  itkSetMacro(AlignmentOffset, SizeValueType);
+  itkGetConstMacro(AlignmentOffset, SizeValueType);
+
+  /** Set/Get the number of pixels to aim for in a slab.  The default, 0,
+   * only splits the region into the requested number of slabs. */
+  itkSetMacro(PieceSize, SizeValueType);
+  itkGetConstMacro(PieceSize, SizeValueType);
+
+protected:
+  AlignedImageRegionSplitter() = default;
+  ~AlignedImageRegionSplitter() override = default;
+
+  unsigned int
+  GetNumberOfSplitsInternal(unsigned int         dim,
+                            const IndexValueType itkNotUsed(regionIndex)[],
+                            const SizeValueType  regionSize[],
+                            unsigned int         requestedNumber) const override
+  {
+    const unsigned int  splitDimension = SplitDimension(dim, regionSize);
+    const SizeValueType size = regionSize[splitDimension];
+    if (size == 0)
+    {
+      return 1;
+    }
+    const SizeValueType sliceSize = SliceSize(splitDimension, regionSize);
+
+    SizeValueType numberOfSlabs = std::min<SizeValueType>(std::max(requestedNumber, 1u), size);
+    if (m_PieceSize > 0)
+    {
+      const SizeValueType slabSize = std::max<SizeValueType>(1, m_PieceSize / sliceSize);
+      numberOfSlabs = std::max(numberOfSlabs, (size + slabSize - 1) / slabSize);
+    }
+    numberOfSlabs = std::min<SizeValueType>(numberOfSlabs, std::numeric_limits<unsigned int>::max());
+    return static_cast<unsigned int>(numberOfSlabs);
+  }
+
+  unsigned int
+  GetSplitInternal(unsigned int   dim,
+                   unsigned int   i,
+                   unsigned int   numberOfPieces,
+                   IndexValueType regionIndex[],
+                   SizeValueType  regionSize[]) const override
+  {
+    const unsigned int  splitDimension = SplitDimension(dim, regionSize);
+    const SizeValueType size = regionSize[splitDimension];
+    const SizeValueType sliceSize = SliceSize(splitDimension, regionSize);
+    const SizeValueType numberOfSlabs = std::max(numberOfPieces, 1u);
+
+    const SizeValueType begin = this->SlabBegin(i, numberOfSlabs, size, sliceSize);
+    const SizeValueType end = this->SlabBegin(i + 1, numberOfSlabs, size, sliceSize);
+    regionIndex[splitDimension] += static_cast<IndexValueType>(begin);
+    regionSize[splitDimension] = end - begin;
+    return numberOfPieces;
+  }
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Alignment: " << m_Alignment << std::endl;
+    os << indent << "AlignmentOffset: " << m_AlignmentOffset << std::endl;
+    os << indent << "PieceSize: " << m_PieceSize << std::endl;
+  }
+
+private:
+  /** The slowest dimension with more than one index, or the first. */
+  static unsigned int
+  SplitDimension(unsigned int dim, const SizeValueType regionSize[])
+  {
+    unsigned int splitDimension = dim - 1;
+    while (splitDimension > 0 && regionSize[splitDimension] == 1)
+    {
+      --splitDimension;
+    }
+    return splitDimension;
+  }
+
+  /** Number of pixels per index of the split dimension. */
+  static SizeValueType
+  SliceSize(unsigned int splitDimension, const SizeValueType regionSize[])
+  {
+    SizeValueType sliceSize = 1;
+    for (unsigned int d = 0; d < splitDimension; ++d)
+    {
+      sliceSize *= regionSize[d];
+    }
+    return std::max<SizeValueType>(sliceSize, 1);
+  }
+
+  /** First index along the split dimension of slab \c i of
+   * \c numberOfSlabs, from the start of the region.  The boundaries of
+   * balanced slabs are rounded up to the next aligned slice when the
+   * aligned slices are no further apart than a slab, and the last slab is
+   * not left empty. */
+  SizeValueType
+  SlabBegin(SizeValueType i, SizeValueType numberOfSlabs, SizeValueType size, SizeValueType sliceSize) const
+  {
+    const SizeValueType begin = std::min(i, numberOfSlabs) * size / numberOfSlabs;
+    if (i == 0 || i >= numberOfSlabs)
+    {
+      return begin;
+    }
+
+    // Slice s starts aligned when (offset + s * sliceSize) % alignment == 0,
+    // which holds every step slices from the first such slice, if any.
+    const SizeValueType alignment = m_Alignment;
+    const SizeValueType offset = m_AlignmentOffset % alignment;
+    const SizeValueType divisor = std::gcd(alignment, sliceSize % alignment);
+    const SizeValueType step = alignment / divisor;
+    if (step == 1 || step > size / numberOfSlabs || offset % divisor != 0)
+    {
+      return begin;
+    }
+    SizeValueType first = 0;
+    while ((offset + first * sliceSize) % alignment != 0)
+    {
+      ++first;
+    }
+    const auto roundUp = [first, step](SizeValueType slice) {
+      return slice <= first ? first : first + (slice - first + step - 1) / step * step;
+    };
+    if (roundUp((numberOfSlabs - 1) * size / numberOfSlabs) >= size)
+    {
+      return begin;
+    }
+    return roundUp(begin);
+  }
+
+  SizeValueType m_Alignment{ 1 };
+  SizeValueType m_AlignmentOffset{ 0 };
+  SizeValueType m_PieceSize{ 0 };
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,204 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkComponentStatistics_h
+#define itkComponentStatistics_h
+
+#include "itkIntTypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace itk
+{
+
+/** \class ComponentStatistics
+ *
+ * \brief Minimum, maximum, mean, variance and histogram of the values of
+ * one image component.
+ *
+ * SplitComponentsImageFilter accumulates one per component while it splits.
+ * The histogram has a fixed number of equally wide bins over
+ * [lower bound, upper bound]; values outside of the range are counted in the
+ * first or last bin, so the histogram always sums to the number of values.
+ *
+ * Statistics of disjoint sets of values are combined with Merge(), e.g. those
+ * of the work units of an update, or those of the pieces of a streamed
+ * update.
+ *
+ * \ingroup SplitComponents
+ */
+class ComponentStatistics
+{
+public:
+  using HistogramType = std::vector<SizeValueType>;
+
+  /** Statistics without a histogram.  Merging into them adopts the
+   * histogram of the other statistics. */
+  ComponentStatistics() = default;
+
+  ComponentStatistics(unsigned int numberOfBins, double lowerBound, double upperBound)
+    : m_HistogramLowerBound(lowerBound)
+    , m_HistogramUpperBound(upperBound)
+    , m_Histogram(numberOfBins, 0)
+  {}
+
+  SizeValueType
+  GetCount() const
+  {
+    return m_Count;
+  }
+
+  double
+  GetMinimum() const
+  {
+    return m_Minimum;
+  }
+
+  double
+  GetMaximum() const
+  {
+    return m_Maximum;
+  }
+
+  double
+  GetSum() const
+  {
+    return m_Sum;
+  }
+
+  double
+  GetMean() const
+  {
+    return m_Count > 0 ? m_Sum / static_cast<double>(m_Count) : 0.0;
+  }
+
+  /** Unbiased variance, as computed by StatisticsImageFilter. */
+  double
+  GetVariance() const
+  {
+    if (m_Count < 2)
+    {
+      return 0.0;
+    }
+    const auto count = static_cast<double>(m_Count);
+    return std::max(0.0, (m_SumOfSquares - m_Sum * m_Sum / count) / (count - 1.0));
+  }
+
+  double
+  GetSigma() const
+  {
+    return std::sqrt(this->GetVariance());
+  }
+
+  double
+  GetHistogramLowerBound() const
+  {
+    return m_HistogramLowerBound;
+  }
+
+  double
+  GetHistogramUpperBound() const
+  {
+    return m_HistogramUpperBound;
+  }
+
+  /** Number of values in each bin; empty without a histogram. */
+  const HistogramType &
+  GetHistogram() const
+  {
+    return m_Histogram;
+  }
+
+  /** Add \c length values. */
+  template <typename TValue>
+  void
+  Accumulate(const TValue * values, std::size_t length)
+  {
+    double minimum = m_Minimum;
+    double maximum = m_Maximum;
+    double sum = 0.0;
+    double sumOfSquares = 0.0;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      const auto value = static_cast<double>(values[i]);
+      minimum = std::min(minimum, value);
+      maximum = std::max(maximum, value);
+      sum += value;
+      sumOfSquares += value * value;
+    }
+    m_Minimum = minimum;
+    m_Maximum = maximum;
+    m_Sum += sum;
+    m_SumOfSquares += sumOfSquares;
+    m_Count += length;
+
+    if (!m_Histogram.empty())
+    {
+      const double lastBin = static_cast<double>(m_Histogram.size() - 1);
+      const double binsPerUnit =
+        m_HistogramUpperBound > m_HistogramLowerBound
+          ? static_cast<double>(m_Histogram.size()) / (m_HistogramUpperBound - m_HistogramLowerBound)
+          : 0.0;
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        // A NaN lands in the first bin.
+        const double position = (static_cast<double>(values[i]) - m_HistogramLowerBound) * binsPerUnit;
+        ++m_Histogram[static_cast<std::size_t>(std::min(lastBin, std::max(0.0, position)))];
+      }
+    }
+  }
+
+  /** Combine with the statistics of another, disjoint, set of values.  The
+   * histograms must have the same bins. */
+  void
+  Merge(const ComponentStatistics & other)
+  {
+    if (m_Histogram.empty() && m_Count == 0)
+    {
+      m_HistogramLowerBound = other.m_HistogramLowerBound;
+      m_HistogramUpperBound = other.m_HistogramUpperBound;
+      m_Histogram.assign(other.m_Histogram.size(), 0);
+    }
+    m_Count += other.m_Count;
+    m_Minimum = std::min(m_Minimum, other.m_Minimum);
+    m_Maximum = std::max(m_Maximum, other.m_Maximum);
+    m_Sum += other.m_Sum;
+    m_SumOfSquares += other.m_SumOfSquares;
+    for (std::size_t i = 0; i < std::min(m_Histogram.size(), other.m_Histogram.size()); ++i)
+    {
+      m_Histogram[i] += other.m_Histogram[i];
+    }
+  }
+
+private:
+  SizeValueType m_Count{ 0 };
+  double        m_Minimum{ std::numeric_limits<double>::infinity() };
+  double        m_Maximum{ -std::numeric_limits<double>::infinity() };
+  double        m_Sum{ 0.0 };
+  double        m_SumOfSquares{ 0.0 };
+  double        m_HistogramLowerBound{ 0.0 };
+  double        m_HistogramUpperBound{ 0.0 };
+  HistogramType m_Histogram;
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkInterleaveComponentsImageFilter_h
+#define itkInterleaveComponentsImageFilter_h
+
+#include "itkFixedArray.h"
+#include "itkImageToImageFilter.h"
+#include "itkVectorImage.h"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class InterleaveComponentsImageFilter
+ *
+ * \brief Combine scalar images into an Image with multi-component pixels.
+ *
+ * This class is the inverse of SplitComponentsImageFilter.  Input \c i
+ * supplies component \c i of every output pixel.  The output can be an
+ * itk::Image of itk::Vector's, itk::CovariantVector, itk::RGBPixel,
+ * itk::SymmetricSecondRankTensor, or other classes that have the same
+ * interface, or an itk::VectorImage.
+ *
+ * The components mask mirrors the one of SplitComponentsImageFilter.  Inputs
+ * of components that are not selected are not required, and the components
+ * are set to zero, as are the components of the output pixel past
+ * TComponents, e.g. the alpha channel of an RGBA output with TComponents of
+ * 3.
+ *
+ * For a VectorImage output, the number of components per pixel is the
+ * larger of TComponents and the number of indexed inputs.
+ *
+ * Contiguous pixel layouts are interleaved a scanline at a time with the
+ * scalar and vectorized kernels shared with SplitComponentsImageFilter.
+ *
+ * \ingroup SplitComponents
+ *
+ * \sa SplitComponentsImageFilter
+ * \sa ComposeImageFilter
+ */
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents = TOutputImage::ImageDimension>
+class ITK_TEMPLATE_EXPORT InterleaveComponentsImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(InterleaveComponentsImageFilter);
+
+  /** ImageDimension enumeration. */
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+  /** Components enumeration. */
+  static constexpr unsigned int Components = TComponents;
+
+  /** Image types. */
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using OutputRegionType = typename OutputImageType::RegionType;
+
+  /** Type of a single component of an output pixel. */
+  using OutputComponentType =
+    std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const OutputPixelType &>()[0])>>;
+
+  /** Whether the output is an itk::VectorImage. */
+  static constexpr bool OutputIsVectorImage =
+    std::is_same_v<OutputImageType, VectorImage<OutputComponentType, ImageDimension>>;
+
+  /** Standard class type alias. */
+  using Self = InterleaveComponentsImageFilter;
+  using Superclass = ImageToImageFilter<InputImageType, OutputImageType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using ComponentsMaskType = FixedArray<bool, TComponents>;
+
+  /** Run-time type information (and related methods). */
+  itkOverrideGetNameOfClassMacro(InterleaveComponentsImageFilter);
+
+  /** Method of creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Set/Get the components mask.  The mask is as long as the number of
+   * components, and only the components whose value in the mask is true are
+   * read from their input.  The others are set to zero.  The default is all
+   * true. */
+  itkSetMacro(ComponentsMask, ComponentsMaskType);
+  itkGetConstReferenceMacro(ComponentsMask, ComponentsMaskType);
+
+  /** Set/Get the image of the given component. */
+  void
+  SetComponent(unsigned int component, const InputImageType * image)
+  {
+    this->SetInput(component, image);
+  }
+  const InputImageType *
+  GetComponent(unsigned int component) const
+  {
+    return this->GetInput(component);
+  }
+
+protected:
+  InterleaveComponentsImageFilter();
+  ~InterleaveComponentsImageFilter() override = default;
+
+  /** Check that every selected component has an input. */
+  void
+  VerifyPreconditions() const override;
+
+  /** Take the output information from the first selected input, and the
+   * number of components of a VectorImage output from the inputs. */
+  void
+  GenerateOutputInformation() override;
+
+  void
+  BeforeThreadedGenerateData() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputRegionType & outputRegion) override;
+
+private:
+  /** Whether the inputs can be read as flat arrays of InputPixelType and the
+   * output buffer written as a flat array of OutputComponentType. */
+  static constexpr bool CanInterleaveScanlines =
+    std::is_same_v<typename InputImageType::InternalPixelType, InputPixelType> &&
+    std::is_arithmetic_v<InputPixelType> && std::is_arithmetic_v<OutputComponentType> &&
+    (OutputIsVectorImage || (std::is_same_v<typename OutputImageType::InternalPixelType, OutputPixelType> &&
+                             std::is_standard_layout_v<OutputPixelType> &&
+                             sizeof(OutputPixelType) % sizeof(OutputComponentType) == 0 &&
+                             sizeof(OutputPixelType) / sizeof(OutputComponentType) >= TComponents));
+
+  /** Number of components of an output pixel. */
+  unsigned int
+  GetNumberOfOutputComponents() const;
+
+  /** Whether the given component is read from its input. */
+  bool
+  IsComponentSelected(unsigned int component) const
+  {
+    return component >= Components || this->m_ComponentsMask[component];
+  }
+
+  /** Interleave whole scanlines of the region at a time. */
+  void
+  InterleaveScanlines(const OutputRegionType & outputRegion);
+
+  /** Interleave the region one pixel at a time. */
+  void
+  InterleavePixels(const OutputRegionType & outputRegion);
+
+  ComponentsMaskType m_ComponentsMask;
+
+  /** Inputs read by the current update, indexed by component; null for
+   * components that are not selected. */
+  std::vector<const InputImageType *> m_SelectedInputs;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkInterleaveComponentsImageFilter.hxx"
+#endif
+
+#endif
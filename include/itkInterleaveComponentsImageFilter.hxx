@@ -0,0 +1,225 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkInterleaveComponentsImageFilter_hxx
+#define itkInterleaveComponentsImageFilter_hxx
+
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkSplitComponentsKernels.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::InterleaveComponentsImageFilter()
+{
+  this->m_ComponentsMask.Fill(true);
+
+  // Inputs of components that are not selected may be missing, including
+  // the first one.  VerifyPreconditions checks the selected ones.
+  this->SetNumberOfRequiredInputs(0);
+  this->RemoveRequiredInputName("Primary");
+
+  this->DynamicMultiThreadingOn();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+unsigned int
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetNumberOfOutputComponents() const
+{
+  if constexpr (OutputIsVectorImage)
+  {
+    return std::max(Components, static_cast<unsigned int>(this->GetNumberOfIndexedInputs()));
+  }
+  else
+  {
+    return static_cast<unsigned int>(sizeof(OutputPixelType) / sizeof(OutputComponentType));
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::VerifyPreconditions() const
+{
+  Superclass::VerifyPreconditions();
+
+  const unsigned int numberOfComponents = OutputIsVectorImage ? this->GetNumberOfOutputComponents() : Components;
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+  {
+    if (this->IsComponentSelected(ii) && this->GetInput(ii) == nullptr)
+    {
+      itkExceptionMacro("Input of component " << ii << " is required but not set.");
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GenerateOutputInformation()
+{
+  // The superclass copies the information of the primary input, which may
+  // be missing when the first component is not selected.
+  const InputImageType * referenceInput = nullptr;
+  const auto             numberOfInputs = static_cast<unsigned int>(this->GetNumberOfIndexedInputs());
+  for (unsigned int ii = 0; ii < numberOfInputs && referenceInput == nullptr; ++ii)
+  {
+    referenceInput = this->GetInput(ii);
+  }
+  if (referenceInput == nullptr)
+  {
+    itkExceptionMacro("No input image set.");
+  }
+
+  OutputImageType * output = this->GetOutput();
+  output->CopyInformation(referenceInput);
+  if constexpr (OutputIsVectorImage)
+  {
+    output->SetNumberOfComponentsPerPixel(this->GetNumberOfOutputComponents());
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::BeforeThreadedGenerateData()
+{
+  const unsigned int numberOfComponents = OutputIsVectorImage ? this->GetNumberOfOutputComponents() : Components;
+  this->m_SelectedInputs.assign(numberOfComponents, nullptr);
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+  {
+    if (this->IsComponentSelected(ii))
+    {
+      this->m_SelectedInputs[ii] = this->GetInput(ii);
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::DynamicThreadedGenerateData(
+  const OutputRegionType & outputRegion)
+{
+  if constexpr (CanInterleaveScanlines)
+  {
+    this->InterleaveScanlines(outputRegion);
+  }
+  else
+  {
+    this->InterleavePixels(outputRegion);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::InterleaveScanlines(
+  const OutputRegionType & outputRegion)
+{
+  OutputImageType *   output = this->GetOutput();
+  const auto          numberOfComponents = static_cast<unsigned int>(this->m_SelectedInputs.size());
+  const SizeValueType lineLength = outputRegion.GetSize(0);
+
+  // Number of components between consecutive pixels of the output buffer.
+  std::size_t           stride = 0;
+  OutputComponentType * outputBuffer = nullptr;
+  if constexpr (OutputIsVectorImage)
+  {
+    stride = output->GetNumberOfComponentsPerPixel();
+    outputBuffer = output->GetBufferPointer();
+  }
+  else
+  {
+    stride = sizeof(OutputPixelType) / sizeof(OutputComponentType);
+    outputBuffer = reinterpret_cast<OutputComponentType *>(output->GetBufferPointer());
+  }
+
+  std::vector<const InputPixelType *> inputLines(numberOfComponents, nullptr);
+  for (ImageScanlineConstIterator<OutputImageType> outIt(output, outputRegion); !outIt.IsAtEnd(); outIt.NextLine())
+  {
+    const typename OutputImageType::IndexType lineIndex = outIt.GetIndex();
+    for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+    {
+      const InputImageType * input = this->m_SelectedInputs[ii];
+      if (input)
+      {
+        inputLines[ii] = input->GetBufferPointer() + input->ComputeOffset(lineIndex);
+      }
+    }
+    OutputComponentType * outputLine = outputBuffer + output->ComputeOffset(lineIndex) * stride;
+    SplitComponentsDetail::InterleaveScanline(inputLines.data(), numberOfComponents, lineLength, outputLine, stride);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+InterleaveComponentsImageFilter<TInputImage, TOutputImage, TComponents>::InterleavePixels(
+  const OutputRegionType & outputRegion)
+{
+  OutputImageType *  output = this->GetOutput();
+  const auto         numberOfComponents = static_cast<unsigned int>(this->m_SelectedInputs.size());
+  const unsigned int numberOfOutputComponents = this->GetNumberOfOutputComponents();
+
+  using InputIteratorType = ImageRegionConstIterator<InputImageType>;
+  std::vector<InputIteratorType> inIts(numberOfComponents);
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+  {
+    if (this->m_SelectedInputs[ii])
+    {
+      InputIteratorType inIt(this->m_SelectedInputs[ii], outputRegion);
+      inIt.GoToBegin();
+      inIts[ii] = inIt;
+    }
+  }
+
+  OutputPixelType outputPixel;
+  if constexpr (OutputIsVectorImage)
+  {
+    outputPixel.SetSize(numberOfOutputComponents);
+  }
+  for (unsigned int ii = 0; ii < numberOfOutputComponents; ++ii)
+  {
+    outputPixel[ii] = OutputComponentType{};
+  }
+
+  ImageRegionIterator<OutputImageType> outIt(output, outputRegion);
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+  {
+    for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+    {
+      if (this->m_SelectedInputs[ii])
+      {
+        outputPixel[ii] = static_cast<OutputComponentType>(inIts[ii].Get());
+        ++(inIts[ii]);
+      }
+    }
+    outIt.Set(outputPixel);
+  }
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSplitAxisImageFilter_h
+#define itkSplitAxisImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace itk
+{
+
+namespace SplitAxisDetail
+{
+/** A pixel container that imports a range of the buffer of another
+ * container, and keeps that container alive as long as it is itself. */
+template <typename TContainer>
+class ITK_TEMPLATE_EXPORT SliceViewContainer : public TContainer
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SliceViewContainer);
+
+  using Self = SliceViewContainer;
+  using Superclass = TContainer;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(SliceViewContainer);
+
+  void
+  SetViewedContainer(const TContainer * container)
+  {
+    this->m_ViewedContainer = container;
+  }
+
+protected:
+  SliceViewContainer() = default;
+  ~SliceViewContainer() override = default;
+
+private:
+  typename TContainer::ConstPointer m_ViewedContainer;
+};
+} // end namespace SplitAxisDetail
+
+/** \class SplitAxisImageFilter
+ *
+ * \brief Split an image along one of its axes into images of one dimension
+ * less.
+ *
+ * This class puts each slice of the input along the chosen axis on its own
+ * output, e.g. each volume of a 4D time series, or each slice of a volume.
+ * Output i holds the slice at offset i from the start of the largest
+ * possible region along the axis, and there are as many outputs as slices,
+ * known once UpdateOutputInformation() has run.  As with
+ * ExtractImageFilter, the outputs drop the axis from the index, spacing,
+ * origin and direction of the input; a direction that is singular without
+ * the axis is replaced by the identity.
+ *
+ * Only the selected slices are populated, see SetSliceSelected() and
+ * SetSelectedSlices(); the outputs of the others keep their index but are
+ * released.  The input is only requested over the range of the selected
+ * slices.
+ *
+ * When the axis is the slowest one of the input, each slice is a contiguous
+ * range of the input buffer, and when the pixel buffers of the input and
+ * output types match, the outputs are views into the input buffer instead of
+ * copies.  Each view keeps the input buffer alive, so an output may outlive
+ * the filter and the input.  The views alias the input: writing to an
+ * output, e.g. with SetPixel() or a downstream filter running in place,
+ * changes the input.  Turn ViewSlices off to copy the slices when the
+ * outputs are to be modified.  Other slices are copied by the
+ * multi-threader.
+ *
+ * \ingroup SplitComponents
+ *
+ * \sa SplitComponentsImageFilter
+ * \sa ExtractImageFilter
+ */
+template <typename TInputImage, typename TOutputImage>
+class ITK_TEMPLATE_EXPORT SplitAxisImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SplitAxisImageFilter);
+
+  /** ImageDimension enumeration. */
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TOutputImage::ImageDimension;
+  static_assert(OutputImageDimension + 1 == InputImageDimension,
+                "The output images must have one dimension less than the input image.");
+
+  /** Image types. */
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputRegionType = typename InputImageType::RegionType;
+  using OutputRegionType = typename OutputImageType::RegionType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using OutputPixelContainerType = typename OutputImageType::PixelContainer;
+
+  /** Whether the outputs can view the pixel buffer of the input. */
+  static constexpr bool CanViewInputBuffer =
+    std::is_same_v<typename InputImageType::PixelContainer, OutputPixelContainerType>;
+
+  /** Standard class type alias. */
+  using Self = SplitAxisImageFilter;
+  using Superclass = ImageToImageFilter<InputImageType, OutputImageType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkOverrideGetNameOfClassMacro(SplitAxisImageFilter);
+
+  /** Method of creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Set/Get the axis of the input to split along.  The default is the
+   * slowest axis, e.g. time for a 4D time series. */
+  itkSetClampMacro(Axis, unsigned int, 0, InputImageDimension - 1);
+  itkGetConstMacro(Axis, unsigned int);
+
+  /** Set/Get whether the outputs may view the input buffer instead of
+   * copying it, when the axis is the slowest one.  On by default. */
+  itkSetMacro(ViewSlices, bool);
+  itkGetConstMacro(ViewSlices, bool);
+  itkBooleanMacro(ViewSlices);
+
+  /** Select or deselect a single slice.  All slices are selected by
+   * default. */
+  void
+  SetSliceSelected(unsigned int slice, bool selected);
+  bool
+  GetSliceSelected(unsigned int slice) const;
+
+  /** Select only the given slices, deselecting all others. */
+  void
+  SetSelectedSlices(const std::vector<unsigned int> & slices);
+
+  /** Number of slices, and so of outputs, known once
+   * UpdateOutputInformation() has run. */
+  unsigned int
+  GetNumberOfSlices() const
+  {
+    return static_cast<unsigned int>(this->GetNumberOfIndexedOutputs());
+  }
+
+protected:
+  SplitAxisImageFilter();
+  ~SplitAxisImageFilter() override = default;
+
+  /** Create an output per slice, and drop the axis from the information of
+   * the input. */
+  void
+  GenerateOutputInformation() override;
+
+  /** Request the input over the range of the selected slices. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** View or allocate the outputs of the selected slices. */
+  void
+  AllocateOutputs() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputRegionType & outputRegion) override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The region of the input that holds \c region of the output of
+   * \c slice. */
+  InputRegionType
+  SliceRegion(const OutputRegionType & region, unsigned int slice) const;
+
+  /** Whether every selected slice is a contiguous range of the input
+   * buffer holding the requested region of its output. */
+  bool
+  CanViewSlices() const;
+
+  /** Container of the outputs that view the input buffer. */
+  using SliceViewContainerType = SplitAxisDetail::SliceViewContainer<OutputPixelContainerType>;
+
+  unsigned int m_Axis{ InputImageDimension - 1 };
+
+  /** Selection of the slices; slices past its end are selected when
+   * m_SlicesSelected is true. */
+  std::vector<bool> m_SliceMask;
+  bool              m_SlicesSelected{ true };
+
+  /** Slices copied by the current update; the others are views or not
+   * selected. */
+  std::vector<unsigned int> m_CopiedSlices;
+
+  bool m_ViewSlices{ true };
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkSplitAxisImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSplitAxisImageFilter_hxx
+#define itkSplitAxisImageFilter_hxx
+
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "vnl/algo/vnl_determinant.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+
+template <typename TInputImage, typename TOutputImage>
+SplitAxisImageFilter<TInputImage, TOutputImage>::SplitAxisImageFilter()
+{
+  this->DynamicMultiThreadingOn();
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::SetSliceSelected(unsigned int slice, bool selected)
+{
+  if (this->GetSliceSelected(slice) == selected)
+  {
+    return;
+  }
+  if (slice >= this->m_SliceMask.size())
+  {
+    this->m_SliceMask.resize(slice + 1, this->m_SlicesSelected);
+  }
+  this->m_SliceMask[slice] = selected;
+  this->Modified();
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+bool
+SplitAxisImageFilter<TInputImage, TOutputImage>::GetSliceSelected(unsigned int slice) const
+{
+  return slice < this->m_SliceMask.size() ? this->m_SliceMask[slice] : this->m_SlicesSelected;
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::SetSelectedSlices(const std::vector<unsigned int> & slices)
+{
+  std::vector<bool> sliceMask;
+  for (const unsigned int slice : slices)
+  {
+    if (slice >= sliceMask.size())
+    {
+      sliceMask.resize(slice + 1, false);
+    }
+    sliceMask[slice] = true;
+  }
+
+  if (sliceMask != this->m_SliceMask || this->m_SlicesSelected)
+  {
+    this->m_SliceMask = sliceMask;
+    this->m_SlicesSelected = false;
+    this->Modified();
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::GenerateOutputInformation()
+{
+  // The outputs have one dimension less than the input, so the information
+  // is not copied by the superclass.
+  const InputImageType * input = this->GetInput();
+  if (!input)
+  {
+    return;
+  }
+
+  const InputRegionType & inputRegion = input->GetLargestPossibleRegion();
+  const auto              numberOfSlices = static_cast<unsigned int>(inputRegion.GetSize(this->m_Axis));
+  const auto              numberOfOutputs = static_cast<unsigned int>(this->GetNumberOfIndexedOutputs());
+  this->SetNumberOfIndexedOutputs(std::max(numberOfSlices, 1u));
+  for (unsigned int i = numberOfOutputs; i < numberOfSlices; ++i)
+  {
+    this->SetNthOutput(i, this->MakeOutput(i));
+  }
+
+  OutputRegionType                        outputRegion;
+  typename OutputImageType::SpacingType   outputSpacing;
+  typename OutputImageType::PointType     outputOrigin;
+  typename OutputImageType::DirectionType outputDirection;
+  for (unsigned int i = 0; i < OutputImageDimension; ++i)
+  {
+    const unsigned int inputI = i < this->m_Axis ? i : i + 1;
+    outputRegion.SetIndex(i, inputRegion.GetIndex(inputI));
+    outputRegion.SetSize(i, inputRegion.GetSize(inputI));
+    outputSpacing[i] = input->GetSpacing()[inputI];
+    outputOrigin[i] = input->GetOrigin()[inputI];
+    for (unsigned int j = 0; j < OutputImageDimension; ++j)
+    {
+      const unsigned int inputJ = j < this->m_Axis ? j : j + 1;
+      outputDirection[i][j] = input->GetDirection()[inputI][inputJ];
+    }
+  }
+  if (vnl_determinant(outputDirection.GetVnlMatrix()) == 0.0)
+  {
+    outputDirection.SetIdentity();
+  }
+
+  for (unsigned int i = 0; i < numberOfSlices; ++i)
+  {
+    OutputImageType * output = this->GetOutput(i);
+    if (output)
+    {
+      output->SetLargestPossibleRegion(outputRegion);
+      output->SetSpacing(outputSpacing);
+      output->SetOrigin(outputOrigin);
+      output->SetDirection(outputDirection);
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  auto * input = const_cast<InputImageType *>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+
+  const unsigned int numberOfSlices = this->GetNumberOfSlices();
+  unsigned int       first = numberOfSlices;
+  unsigned int       last = 0;
+  for (unsigned int i = 0; i < numberOfSlices; ++i)
+  {
+    if (this->GetSliceSelected(i))
+    {
+      first = std::min(first, i);
+      last = i;
+    }
+  }
+  if (first == numberOfSlices)
+  {
+    // Nothing to split, but the region must not be empty.
+    first = 0;
+  }
+
+  InputRegionType inputRegion = this->SliceRegion(this->GetOutput()->GetRequestedRegion(), first);
+  inputRegion.SetSize(this->m_Axis, std::max(last, first) - first + 1);
+  input->SetRequestedRegion(inputRegion);
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+auto
+SplitAxisImageFilter<TInputImage, TOutputImage>::SliceRegion(const OutputRegionType & region,
+                                                             unsigned int             slice) const -> InputRegionType
+{
+  InputRegionType inputRegion;
+  for (unsigned int i = 0; i < OutputImageDimension; ++i)
+  {
+    const unsigned int inputI = i < this->m_Axis ? i : i + 1;
+    inputRegion.SetIndex(inputI, region.GetIndex(i));
+    inputRegion.SetSize(inputI, region.GetSize(i));
+  }
+  inputRegion.SetIndex(this->m_Axis,
+                       this->GetInput()->GetLargestPossibleRegion().GetIndex(this->m_Axis) +
+                         static_cast<IndexValueType>(slice));
+  inputRegion.SetSize(this->m_Axis, 1);
+  return inputRegion;
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+bool
+SplitAxisImageFilter<TInputImage, TOutputImage>::CanViewSlices() const
+{
+  if constexpr (!CanViewInputBuffer)
+  {
+    return false;
+  }
+  else
+  {
+    // A slice along the slowest axis is contiguous when the input buffer
+    // holds exactly the output region in the other axes.
+    if (this->m_Axis != InputImageDimension - 1)
+    {
+      return false;
+    }
+    const InputRegionType &  bufferedRegion = this->GetInput()->GetBufferedRegion();
+    const OutputRegionType & outputRegion = this->GetOutput()->GetRequestedRegion();
+    for (unsigned int i = 0; i < OutputImageDimension; ++i)
+    {
+      if (bufferedRegion.GetIndex(i) != outputRegion.GetIndex(i) ||
+          bufferedRegion.GetSize(i) != outputRegion.GetSize(i))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::AllocateOutputs()
+{
+  const InputImageType * input = this->GetInput();
+  const bool             viewSlices = this->m_ViewSlices && this->CanViewSlices();
+  this->m_CopiedSlices.clear();
+
+  const unsigned int numberOfSlices = this->GetNumberOfSlices();
+  for (unsigned int ii = 0; ii < numberOfSlices; ++ii)
+  {
+    OutputImageType * outputPtr = this->GetOutput(ii);
+    if (!outputPtr)
+    {
+      continue;
+    }
+    if (!this->GetSliceSelected(ii))
+    {
+      // Free the buffer of a slice that was selected by an earlier update
+      // instead of keeping stale data alive.
+      outputPtr->ReleaseData();
+      continue;
+    }
+
+    outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+    if constexpr (CanViewInputBuffer)
+    {
+      if (viewSlices)
+      {
+        const InputRegionType slice = this->SliceRegion(outputPtr->GetRequestedRegion(), ii);
+        auto * const          buffer = const_cast<typename OutputImageType::InternalPixelType *>(
+          input->GetBufferPointer() + input->ComputeOffset(slice.GetIndex()));
+        auto container = SliceViewContainerType::New();
+        container->SetImportPointer(buffer, slice.GetNumberOfPixels(), false);
+        container->SetViewedContainer(input->GetPixelContainer());
+        outputPtr->SetPixelContainer(container);
+        continue;
+      }
+    }
+
+    // Do not reuse a view of the input from an earlier update.
+    if (!outputPtr->GetPixelContainer()->GetContainerManageMemory())
+    {
+      outputPtr->SetPixelContainer(OutputPixelContainerType::New());
+    }
+    outputPtr->Allocate();
+    this->m_CopiedSlices.push_back(ii);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(const OutputRegionType & outputRegion)
+{
+  const InputImageType * input = this->GetInput();
+  for (const unsigned int slice : this->m_CopiedSlices)
+  {
+    // Dropping an axis of size one keeps the order of the pixels.
+    ImageRegionConstIterator<InputImageType> inputIt(input, this->SliceRegion(outputRegion, slice));
+    ImageRegionIterator<OutputImageType>     outputIt(this->GetOutput(slice), outputRegion);
+    for (; !outputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+      outputIt.Set(static_cast<OutputPixelType>(inputIt.Get()));
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+SplitAxisImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Axis: " << this->m_Axis << std::endl;
+  os << indent << "ViewSlices: " << this->m_ViewSlices << std::endl;
+  os << indent << "SlicesSelected: " << this->m_SlicesSelected << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -18,12 +18,46 @@
 #ifndef itkSplitComponentsImageFilter_h
 #define itkSplitComponentsImageFilter_h
 
+#include "itkAlignedImageRegionSplitter.h"
+#include "itkComponentStatistics.h"
 #include "itkFixedArray.h"
 #include "itkImageToImageFilter.h"
+#include "itkNthElementImageAdaptor.h"
+#include "itkSplitComponentsKernels.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkVectorImage.h"
+#include "itkVectorImageToImageAdaptor.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace itk
 {
 
+namespace SplitComponentsDetail
+{
+/** Whether a pixel type is a SymmetricSecondRankTensor, e.g. a
+ * DiffusionTensor3D, and its dimension. */
+template <typename TPixel, typename = void>
+struct SymmetricTensorTraits
+{
+  static constexpr bool         IsSymmetricTensor = false;
+  static constexpr unsigned int Dimension = 0;
+};
+
+template <typename TPixel>
+struct SymmetricTensorTraits<TPixel, std::void_t<typename TPixel::EigenValuesArrayType>>
+{
+  static constexpr bool IsSymmetricTensor =
+    std::is_base_of_v<SymmetricSecondRankTensor<typename TPixel::ComponentType, TPixel::Dimension>, TPixel>;
+  static constexpr unsigned int Dimension = IsSymmetricTensor ? TPixel::Dimension : 0;
+};
+} // end namespace SplitComponentsDetail
+
 /** \class SplitComponentsImageFilter
  *
  * \brief Extract components of an Image with multi-component pixels.
@@ -35,6 +69,41 @@ namespace itk
  *
  * It puts an image on every output corresponding to each component.
  *
+ * When the input is an itk::Image whose pixels are laid out as contiguous
+ * arithmetic components and the output pixel is arithmetic, the components
+ * are copied a scanline at a time directly from the pixel buffers.  On x86
+ * CPUs, 1, 2 and 4 byte components with 2, 3, 4 or 6 components per pixel,
+ * e.g. RGB, RGBA, 3-vectors of float and 3D tensors of float, are split with
+ * SSSE3 or AVX2 byte shuffles chosen at run time when the output pixel type
+ * matches the component type.  Other pixel types are split one pixel at a
+ * time through their operator[].
+ *
+ * For an itk::VectorImage input the number of outputs is the number of
+ * components per pixel of the input, known once UpdateOutputInformation()
+ * has run, rather than TComponents.  The flat VectorImage buffer is read
+ * directly, without building a pixel object per voxel.  The components mask
+ * then applies to the first TComponents components; the others are selected
+ * with SetComponentSelected() or SetSelectedComponents().
+ *
+ * Each component can be shifted, scaled and clamped to the range of the
+ * output pixel type within the same pass, see SetComponentShift(),
+ * SetComponentScale() and SetClampOutput().  Without clamping, the
+ * components left unchanged are still split by the vectorized kernels.
+ *
+ * Scalars derived from each pixel can be computed in the same traversal on
+ * additional outputs: the magnitude of the pixel, and for symmetric tensors
+ * the trace, the fractional anisotropy and the eigenvalues.  See
+ * SetComputeMagnitude() and the following methods.
+ *
+ * The output region is split into slabs of whole rows or slices that are
+ * small enough for the piece of the input and of all the outputs of a work
+ * unit to stay in cache, so work units do not evict their own output
+ * streams.  Where that leaves a slab per work unit, the slabs start on a
+ * cache line of the first output buffer.  See AlignedImageRegionSplitter.
+ *
+ * GetComponentView() offers an alternative to the copied outputs: an image
+ * adaptor that reads one component of the input in place.
+ *
  * \ingroup SplitComponents
  *
  * \sa VectorImageToImageAdaptor
@@ -61,6 +130,32 @@ public:
   using InputPixelType = typename InputImageType::PixelType;
   using OutputPixelType = typename OutputImageType::PixelType;
   using OutputRegionType = typename OutputImageType::RegionType;
+  using OutputPixelContainerType = typename OutputImageType::PixelContainer;
+
+  /** Type of a single component of an input pixel, as returned by its
+   * operator[]. */
+  using InputComponentType =
+    std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const InputPixelType &>()[0])>>;
+
+  /** Whether the input is an itk::VectorImage. */
+  static constexpr bool InputIsVectorImage =
+    std::is_same_v<InputImageType, VectorImage<InputComponentType, ImageDimension>>;
+
+  /** Adaptor that presents one component of the input as a scalar image. */
+  using ComponentViewType = std::conditional_t<InputIsVectorImage,
+                                               VectorImageToImageAdaptor<InputComponentType, ImageDimension>,
+                                               NthElementImageAdaptor<InputImageType, OutputPixelType>>;
+
+  /** Whether the input pixels are symmetric tensors, and their dimension. */
+  static constexpr bool InputIsSymmetricTensor =
+    SplitComponentsDetail::SymmetricTensorTraits<InputPixelType>::IsSymmetricTensor;
+  static constexpr unsigned int TensorDimension =
+    SplitComponentsDetail::SymmetricTensorTraits<InputPixelType>::Dimension;
+
+  /** Image type of the derived outputs: float for float components, double
+   * otherwise. */
+  using DerivedPixelType = std::conditional_t<std::is_same_v<InputComponentType, float>, float, double>;
+  using DerivedImageType = Image<DerivedPixelType, ImageDimension>;
 
   /** Standard class type alias. */
   using Self = SplitComponentsImageFilter;
@@ -78,23 +173,379 @@ public:
 
   /** Set/Get the components mask.  The mask is as long as the number of
    * components, and only values in the mask that evaluate are true will be
-   * populated in the output.  The default is all true. */
+   * populated in the output.  The default is all true.  Outputs of
+   * components that are not selected keep their index but are released
+   * rather than allocated. */
   itkSetMacro(ComponentsMask, ComponentsMaskType);
   itkGetConstReferenceMacro(ComponentsMask, ComponentsMaskType);
 
+  /** Select or deselect a single component.  Unlike the components mask,
+   * this also reaches the components of a VectorImage input past
+   * TComponents. */
+  void
+  SetComponentSelected(unsigned int component, bool selected);
+  bool
+  GetComponentSelected(unsigned int component) const;
+
+  /** Select only the given components, deselecting all others including
+   * the components of a VectorImage input past TComponents. */
+  void
+  SetSelectedComponents(const std::vector<unsigned int> & components);
+
+  /** Set/Get a buffer for the output of a component, e.g. a file mapped
+   * into memory, that the component is split into instead of a buffer the
+   * filter allocates.  The container must hold exactly the requested region
+   * of the output when the filter executes, and must outlive its use by the
+   * output.  A null container restores the allocation. */
+  void
+  SetOutputPixelContainer(unsigned int component, OutputPixelContainerType * container);
+  OutputPixelContainerType *
+  GetOutputPixelContainer(unsigned int component) const;
+
+  /** Set/Get whether to place the pages of the output buffers on the NUMA
+   * nodes of the work units that write them.  The buffers are then
+   * allocated afresh on each update, and before the split each work unit
+   * writes to every page of the slabs of the outputs it will split.  Where
+   * the first write to a page decides its node, as on Linux, each socket
+   * then mostly writes to its local memory, instead of all of them to the
+   * memory of the thread that allocated the buffers.  This takes precedence
+   * over ReuseOutputBuffers: no buffer is taken from or kept in the pool,
+   * since its pages were placed by an earlier split.  Buffers supplied with
+   * SetOutputPixelContainer() are not touched.  Off by default. */
+  itkSetMacro(FirstTouchOutputs, bool);
+  itkGetConstMacro(FirstTouchOutputs, bool);
+  itkBooleanMacro(FirstTouchOutputs);
+
+  /** Set/Get whether to recycle the output buffers across updates.  When
+   * on, the buffers of the outputs of an update, and those handed back with
+   * RecycleOutputBuffer(), are kept in a pool when the next update releases
+   * them, and the outputs are split into buffers from the pool that are
+   * large enough before any is allocated.  Updating the filter again with
+   * the same requested region, as for the frames of a series, then neither
+   * allocates nor faults in pages.  A buffer is only taken back from an
+   * output when no one else refers to it.  Off by default, which empties the
+   * pool on the next update, as does FirstTouchOutputs. */
+  itkSetMacro(ReuseOutputBuffers, bool);
+  itkGetConstMacro(ReuseOutputBuffers, bool);
+  itkBooleanMacro(ReuseOutputBuffers);
+
+  /** Set/Get whether to generate only the output that is updated.  When
+   * on, updating an output, e.g. with GetOutput(i)->Update(), allocates and
+   * splits only that component, or computes only that derived output, and
+   * the outputs generated before are kept as long as the input and the
+   * filter are unchanged.  The others are generated when they are updated
+   * in turn.  Updating the filter itself updates its first output.  This
+   * suits viewing one component at a time; when all the components are
+   * used, splitting them together reads the input only once.  Off by
+   * default. */
+  itkSetMacro(LazyComponents, bool);
+  itkGetConstMacro(LazyComponents, bool);
+  itkBooleanMacro(LazyComponents);
+
+  /** Hand the buffer of an output that was taken from the filter, e.g. with
+   * DisconnectPipeline(), back to the pool for the next update.  Its pixels
+   * must not be used afterwards.  Buffers that the container does not own
+   * are ignored. */
+  void
+  RecycleOutputBuffer(OutputPixelContainerType * container);
+
+  /** Number of buffers waiting in the pool. */
+  SizeValueType
+  GetNumberOfPooledOutputBuffers() const
+  {
+    return static_cast<SizeValueType>(this->m_OutputBufferPool.size());
+  }
+
+  /** Set/Get the shift and scale applied to a component as it is split, as
+   * with ShiftScaleImageFilter: output = (input + shift) * scale.  The
+   * defaults, 0 and 1, copy the component unchanged.  Converting in the
+   * split replaces a separate rescaling filter per component, and its pass
+   * over memory and buffer. */
+  void
+  SetComponentShift(unsigned int component, double shift);
+  double
+  GetComponentShift(unsigned int component) const;
+  void
+  SetComponentScale(unsigned int component, double scale);
+  double
+  GetComponentScale(unsigned int component) const;
+
+  /** Clamp all the components to the range of the output pixel type.  The
+   * shifted or scaled components of an integral output are clamped anyway,
+   * with NaN mapped to 0, so this decides whether the others are too, e.g.
+   * when splitting float into unsigned char, and whether a floating point
+   * output is clamped at all.  Off by default. */
+  itkSetMacro(ClampOutput, bool);
+  itkGetConstMacro(ClampOutput, bool);
+  itkBooleanMacro(ClampOutput);
+
+  /** Set/Get whether to compute the statistics of each selected component,
+   * as written to its output, while splitting.  This spares a
+   * StatisticsImageFilter and a histogram pass over every output.  Off by
+   * default. */
+  itkSetMacro(ComputeStatistics, bool);
+  itkGetConstMacro(ComputeStatistics, bool);
+  itkBooleanMacro(ComputeStatistics);
+
+  /** Set/Get the number of bins of the component histograms, and the range
+   * they cover.  The default is 256 bins over the range of an integral
+   * output pixel type; a floating point output has no histogram unless both
+   * are set.  No histogram is computed with 0 bins, and an update with bins
+   * over an empty or infinitely wide range throws. */
+  itkSetMacro(HistogramNumberOfBins, unsigned int);
+  itkGetConstMacro(HistogramNumberOfBins, unsigned int);
+  itkSetMacro(HistogramLowerBound, double);
+  itkGetConstMacro(HistogramLowerBound, double);
+  itkSetMacro(HistogramUpperBound, double);
+  itkGetConstMacro(HistogramUpperBound, double);
+
+  /** Set/Get whether to compute the magnitude of the pixels, the Euclidean
+   * norm of all of their components as stored, on GetMagnitudeOutput(), even
+   * those beyond the TComponents split.  For a symmetric tensor this counts
+   * each off-diagonal element once.  Off by default. */
+  itkSetMacro(ComputeMagnitude, bool);
+  itkGetConstMacro(ComputeMagnitude, bool);
+  itkBooleanMacro(ComputeMagnitude);
+
+  /** Set/Get whether to compute the trace, the fractional anisotropy and the
+   * eigenvalues of symmetric tensor pixels, e.g. of DiffusionTensor3D, on
+   * GetTraceOutput(), GetFractionalAnisotropyOutput() and
+   * GetEigenValueOutput().  The eigenvalues are in ascending order.  Only
+   * valid for symmetric tensor pixels.  Off by default. */
+  itkSetMacro(ComputeTrace, bool);
+  itkGetConstMacro(ComputeTrace, bool);
+  itkBooleanMacro(ComputeTrace);
+  itkSetMacro(ComputeFractionalAnisotropy, bool);
+  itkGetConstMacro(ComputeFractionalAnisotropy, bool);
+  itkBooleanMacro(ComputeFractionalAnisotropy);
+  itkSetMacro(ComputeEigenValues, bool);
+  itkGetConstMacro(ComputeEigenValues, bool);
+  itkBooleanMacro(ComputeEigenValues);
+
+  /** Get the derived outputs.  They are named outputs, "Magnitude",
+   * "Trace", "FractionalAnisotropy" and "EigenValue0", "EigenValue1", ...,
+   * beside the indexed component outputs.  Those of tensor measures are
+   * null unless the input pixels are symmetric tensors. */
+  DerivedImageType *
+  GetMagnitudeOutput();
+  DerivedImageType *
+  GetTraceOutput();
+  DerivedImageType *
+  GetFractionalAnisotropyOutput();
+  DerivedImageType *
+  GetEigenValueOutput(unsigned int eigenValue);
+
+  /** Get the statistics of a component computed by the last update.  Only
+   * available for selected components, with ComputeStatistics on. */
+  const ComponentStatistics &
+  GetComponentStatistics(unsigned int component) const;
+
+  /** Get an adaptor that reads the given component of the input in place.
+   * The adaptor addresses the input buffer with a stride of one pixel, so it
+   * allocates and copies nothing; it can be passed to any filter that takes
+   * an image of that component type.  The adaptor refers to the input, and
+   * updating the adaptor updates the input.  The component is only copied to
+   * contiguous memory when a downstream filter writes it to its output, or
+   * when the regular outputs of this filter are used instead. */
+  typename ComponentViewType::Pointer
+  GetComponentView(unsigned int component) const;
+
+  /** Statistics of the last update: the bytes read from the input and
+   * written to the selected outputs, and the wall time in seconds spent
+   * splitting, which excludes the allocation of the outputs. */
+  itkGetConstMacro(InputBytes, SizeValueType);
+  itkGetConstMacro(OutputBytes, SizeValueType);
+  itkGetConstMacro(ElapsedTime, double);
+
+  /** Wall time in seconds of each slab of the last update, in the order
+   * they finished.  The slabs are the pieces the region was split into;
+   * there may be more of them than work units, and a thread may split
+   * several. */
+  itkGetConstReferenceMacro(SlabTimes, std::vector<double>);
+  unsigned int
+  GetNumberOfExecutedSlabs() const
+  {
+    return static_cast<unsigned int>(this->m_SlabTimes.size());
+  }
+
 protected:
   SplitComponentsImageFilter();
   ~SplitComponentsImageFilter() override = default;
 
+  /** Create the derived outputs by name. */
+  using Superclass::MakeOutput;
+  DataObject::Pointer
+  MakeOutput(const ProcessObject::DataObjectIdentifierType & name) override;
+
+  /** Check that the requested derived outputs apply to the input pixels. */
+  void
+  VerifyPreconditions() const override;
+
+  /** For a VectorImage input, create one output per component. */
+  void
+  GenerateOutputInformation() override;
+
+  /** In lazy mode, generate only \c output, and release the other outputs
+   * that were not up to date, as they were not generated. */
+  void
+  UpdateOutputData(DataObject * output) override;
+
+  /** Take the buffers of the outputs into the pool before they are
+   * released, when ReuseOutputBuffers is on.  In lazy mode, only the output
+   * being generated is prepared. */
+  void
+  PrepareOutputs() override;
+
   /** Do not allocate outputs that we will not populate. */
   void
   AllocateOutputs() override;
 
+  /** Split the output region with the AlignedImageRegionSplitter, and
+   * process the slabs on the multi-threader. */
+  void
+  GenerateData() override;
+
+  const ImageRegionSplitterBase *
+  GetImageRegionSplitter() const override;
+
+  /** Set up the conversion of the components, reset the statistics and
+   * start timing the update. */
+  void
+  BeforeThreadedGenerateData() override;
+
   void
   DynamicThreadedGenerateData(const OutputRegionType & outputRegion) override;
 
+  /** Stop timing the update. */
+  void
+  AfterThreadedGenerateData() override;
+
 private:
+  /** Whether the input buffer can be read as a flat array of
+   * InputComponentType and the outputs written as flat arrays of
+   * OutputPixelType. */
+  static constexpr bool CanSplitScanlines =
+    std::is_same_v<typename OutputImageType::InternalPixelType, OutputPixelType> &&
+    std::is_arithmetic_v<OutputPixelType> && std::is_arithmetic_v<InputComponentType> &&
+    (InputIsVectorImage || (std::is_same_v<typename InputImageType::InternalPixelType, InputPixelType> &&
+                            std::is_standard_layout_v<InputPixelType> &&
+                            sizeof(InputPixelType) % sizeof(InputComponentType) == 0 &&
+                            sizeof(InputPixelType) / sizeof(InputComponentType) >= TComponents));
+
+  /** Whether the components can be shifted, scaled and clamped. */
+  static constexpr bool CanConvertComponents =
+    std::is_arithmetic_v<OutputPixelType> && std::is_arithmetic_v<InputComponentType>;
+
+  /** Split whole scanlines of the region at a time, adding the values
+   * written to \c statistics unless it is empty. */
+  void
+  SplitScanlines(const OutputRegionType & outputRegion, std::vector<ComponentStatistics> & statistics);
+
+  /** Split the region one pixel at a time. */
+  void
+  SplitPixels(const OutputRegionType & outputRegion, std::vector<ComponentStatistics> & statistics);
+
+  /** Bytes of a cache line, that slabs are aligned to in the outputs, of a
+   * page, that first touch writes to, and of the input and outputs to aim
+   * for in a slab, about the size of a per-core cache. */
+  static constexpr SizeValueType CacheLineSize = 64;
+  static constexpr SizeValueType PageSize = 4096;
+  static constexpr SizeValueType SlabCacheSize = 1 << 20;
+
+  /** Indices of the derived outputs in m_DerivedOutputs; the eigenvalues
+   * follow from EigenValueIndex. */
+  static constexpr unsigned int MagnitudeIndex = 0;
+  static constexpr unsigned int TraceIndex = 1;
+  static constexpr unsigned int FractionalAnisotropyIndex = 2;
+  static constexpr unsigned int EigenValueIndex = 3;
+  static constexpr unsigned int NumberOfDerivedOutputs = InputIsSymmetricTensor ? EigenValueIndex + TensorDimension : 1;
+
+  static std::string
+  GetDerivedOutputName(unsigned int index);
+
+  /** Whether derived output \c index is computed. */
+  bool
+  GetComputeDerivedOutput(unsigned int index) const;
+
+  /** Remove from the pool and return the buffer that holds at least
+   * \c numberOfPixels with the least to spare, or null if there is none. */
+  typename OutputPixelContainerType::Pointer
+  TakePooledOutputBuffer(SizeValueType numberOfPixels);
+
+  /** Write one pixel per page of the part of the buffer of \c image that
+   * holds \c region, which must be contiguous, so the pages are placed on
+   * the NUMA node of the calling thread. */
+  template <typename TImage>
+  static void
+  TouchPages(TImage * image, const OutputRegionType & region);
+
+  /** Compute the tensor measures of \c pixel into element \c offset of the
+   * buffers in \c derived that are not null. */
+  void
+  ComputeTensorMeasures(const InputPixelType & pixel, DerivedPixelType * const * derived, SizeValueType offset) const;
+
   ComponentsMaskType m_ComponentsMask;
+
+  AlignedImageRegionSplitter::Pointer m_RegionSplitter{ AlignedImageRegionSplitter::New() };
+  bool                                m_FirstTouchOutputs{ false };
+
+  /** The output being generated in lazy mode; null when all are. */
+  bool         m_LazyComponents{ false };
+  DataObject * m_LazyOutput{ nullptr };
+
+  /** Selection of the components past TComponents of a VectorImage input,
+   * indexed from TComponents.  Components past its end are selected when
+   * m_ExtraComponentsSelected is true. */
+  std::vector<bool> m_ExtraComponentsMask;
+  bool              m_ExtraComponentsSelected{ true };
+
+  /** Outputs populated by the current update, indexed by component; null
+   * for components that are not selected. */
+  std::vector<OutputImageType *> m_SplitOutputs;
+
+  /** Buffers supplied for the outputs, indexed by component; components
+   * past their end are allocated. */
+  std::vector<typename OutputPixelContainerType::Pointer> m_OutputPixelContainers;
+
+  /** Buffers that the next update may split the outputs into, at most one
+   * per output. */
+  std::vector<typename OutputPixelContainerType::Pointer> m_OutputBufferPool;
+  bool                                                    m_ReuseOutputBuffers{ false };
+
+  /** Shift and scale of each component, indexed by component; components
+   * past their end are not converted. */
+  std::vector<double> m_ComponentShifts;
+  std::vector<double> m_ComponentScales;
+  bool                m_ClampOutput{ false };
+
+  /** Conversion of each component for the current update; empty when the
+   * components are copied unchanged. */
+  std::vector<SplitComponentsDetail::ComponentConversion> m_Conversions;
+
+  bool m_ComputeMagnitude{ false };
+  bool m_ComputeTrace{ false };
+  bool m_ComputeFractionalAnisotropy{ false };
+  bool m_ComputeEigenValues{ false };
+
+  /** Derived outputs populated by the current update, indexed as above;
+   * null for those that are not computed. */
+  std::vector<DerivedImageType *> m_DerivedOutputs;
+
+  bool         m_ComputeStatistics{ false };
+  unsigned int m_HistogramNumberOfBins{ 256 };
+  double       m_HistogramLowerBound{ 0.0 };
+  double       m_HistogramUpperBound{ 0.0 };
+
+  /** Statistics of each component, merged from those of the slabs;
+   * empty unless ComputeStatistics is on. */
+  std::vector<ComponentStatistics> m_ComponentStatistics;
+
+  SizeValueType                         m_InputBytes{ 0 };
+  SizeValueType                         m_OutputBytes{ 0 };
+  double                                m_ElapsedTime{ 0.0 };
+  std::vector<double>                   m_SlabTimes;
+  std::mutex                            m_SlabMutex;
+  std::chrono::steady_clock::time_point m_StartTime;
 };
 
 } // end namespace itk
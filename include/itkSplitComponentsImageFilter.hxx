@@ -21,6 +21,16 @@
 
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
 
 namespace itk
 {
@@ -30,6 +40,18 @@ SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SplitCompone
 {
   this->m_ComponentsMask.Fill(true);
 
+  if constexpr (std::numeric_limits<OutputPixelType>::is_integer)
+  {
+    this->m_HistogramLowerBound = static_cast<double>(NumericTraits<OutputPixelType>::NonpositiveMin());
+    this->m_HistogramUpperBound = static_cast<double>(NumericTraits<OutputPixelType>::max());
+  }
+  else
+  {
+    // The range of a floating point type is too wide to bin, or even to
+    // take the width of for double.
+    this->m_HistogramNumberOfBins = 0;
+  }
+
   this->SetNumberOfIndexedOutputs(Components);
 
   // ImageSource only does this for the first output.
@@ -38,34 +60,796 @@ SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SplitCompone
     this->SetNthOutput(i, this->MakeOutput(i));
   }
 
+  for (unsigned int i = 0; i < NumberOfDerivedOutputs; ++i)
+  {
+    const std::string name = GetDerivedOutputName(i);
+    this->ProcessObject::SetOutput(name, this->MakeOutput(name));
+  }
+
   this->DynamicMultiThreadingOn();
 }
 
 
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+std::string
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetDerivedOutputName(unsigned int index)
+{
+  switch (index)
+  {
+    case MagnitudeIndex:
+      return "Magnitude";
+    case TraceIndex:
+      return "Trace";
+    case FractionalAnisotropyIndex:
+      return "FractionalAnisotropy";
+    default:
+      return "EigenValue" + std::to_string(index - EigenValueIndex);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+bool
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComputeDerivedOutput(unsigned int index) const
+{
+  switch (index)
+  {
+    case MagnitudeIndex:
+      return this->m_ComputeMagnitude;
+    case TraceIndex:
+      return this->m_ComputeTrace;
+    case FractionalAnisotropyIndex:
+      return this->m_ComputeFractionalAnisotropy;
+    default:
+      return this->m_ComputeEigenValues;
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+DataObject::Pointer
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::MakeOutput(
+  const ProcessObject::DataObjectIdentifierType & name)
+{
+  for (unsigned int i = 0; i < NumberOfDerivedOutputs; ++i)
+  {
+    if (name == GetDerivedOutputName(i))
+    {
+      return DerivedImageType::New().GetPointer();
+    }
+  }
+  return Superclass::MakeOutput(name);
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetMagnitudeOutput() -> DerivedImageType *
+{
+  return itkDynamicCastInDebugMode<DerivedImageType *>(
+    this->ProcessObject::GetOutput(GetDerivedOutputName(MagnitudeIndex)));
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetTraceOutput() -> DerivedImageType *
+{
+  if (!InputIsSymmetricTensor)
+  {
+    return nullptr;
+  }
+  return itkDynamicCastInDebugMode<DerivedImageType *>(
+    this->ProcessObject::GetOutput(GetDerivedOutputName(TraceIndex)));
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetFractionalAnisotropyOutput()
+  -> DerivedImageType *
+{
+  if (!InputIsSymmetricTensor)
+  {
+    return nullptr;
+  }
+  return itkDynamicCastInDebugMode<DerivedImageType *>(
+    this->ProcessObject::GetOutput(GetDerivedOutputName(FractionalAnisotropyIndex)));
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetEigenValueOutput(unsigned int eigenValue)
+  -> DerivedImageType *
+{
+  if (eigenValue >= TensorDimension)
+  {
+    return nullptr;
+  }
+  return itkDynamicCastInDebugMode<DerivedImageType *>(
+    this->ProcessObject::GetOutput(GetDerivedOutputName(EigenValueIndex + eigenValue)));
+}
+
+
 template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
 void
-SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::AllocateOutputs()
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::VerifyPreconditions() const
 {
-  using ImageBaseType = ImageBase<TOutputImage::ImageDimension>;
-  typename ImageBaseType::Pointer outputPtr;
+  Superclass::VerifyPreconditions();
+
+  if (!InputIsSymmetricTensor &&
+      (this->m_ComputeTrace || this->m_ComputeFractionalAnisotropy || this->m_ComputeEigenValues))
+  {
+    itkExceptionMacro("The trace, fractional anisotropy and eigenvalues require symmetric tensor pixels.");
+  }
+  if (!std::is_arithmetic_v<InputComponentType> && this->m_ComputeMagnitude)
+  {
+    itkExceptionMacro("The magnitude requires arithmetic pixel components.");
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SetComponentSelected(unsigned int component,
+                                                                                         bool         selected)
+{
+  if (this->GetComponentSelected(component) == selected)
+  {
+    return;
+  }
+  if (component < Components)
+  {
+    this->m_ComponentsMask[component] = selected;
+  }
+  else
+  {
+    const unsigned int extra = component - Components;
+    if (extra >= this->m_ExtraComponentsMask.size())
+    {
+      this->m_ExtraComponentsMask.resize(extra + 1, this->m_ExtraComponentsSelected);
+    }
+    this->m_ExtraComponentsMask[extra] = selected;
+  }
+  this->Modified();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+bool
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComponentSelected(unsigned int component) const
+{
+  if (component < Components)
+  {
+    return this->m_ComponentsMask[component];
+  }
+  const unsigned int extra = component - Components;
+  if (extra >= this->m_ExtraComponentsMask.size())
+  {
+    return this->m_ExtraComponentsSelected;
+  }
+  return this->m_ExtraComponentsMask[extra];
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SetSelectedComponents(
+  const std::vector<unsigned int> & components)
+{
+  ComponentsMaskType componentsMask(false);
+  std::vector<bool>  extraComponentsMask;
+  for (const unsigned int component : components)
+  {
+    if (component < Components)
+    {
+      componentsMask[component] = true;
+    }
+    else
+    {
+      const unsigned int extra = component - Components;
+      if (extra >= extraComponentsMask.size())
+      {
+        extraComponentsMask.resize(extra + 1, false);
+      }
+      extraComponentsMask[extra] = true;
+    }
+  }
+
+  if (componentsMask != this->m_ComponentsMask || extraComponentsMask != this->m_ExtraComponentsMask ||
+      this->m_ExtraComponentsSelected)
+  {
+    this->m_ComponentsMask = componentsMask;
+    this->m_ExtraComponentsMask = extraComponentsMask;
+    this->m_ExtraComponentsSelected = false;
+    this->Modified();
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SetOutputPixelContainer(
+  unsigned int               component,
+  OutputPixelContainerType * container)
+{
+  if (this->GetOutputPixelContainer(component) == container)
+  {
+    return;
+  }
+  if (component >= this->m_OutputPixelContainers.size())
+  {
+    this->m_OutputPixelContainers.resize(component + 1);
+  }
+  this->m_OutputPixelContainers[component] = container;
+  this->Modified();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetOutputPixelContainer(
+  unsigned int component) const -> OutputPixelContainerType *
+{
+  return component < this->m_OutputPixelContainers.size() ? this->m_OutputPixelContainers[component].GetPointer()
+                                                           : nullptr;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::RecycleOutputBuffer(
+  OutputPixelContainerType * container)
+{
+  if (!container || !container->GetContainerManageMemory() || container->Capacity() == 0)
+  {
+    return;
+  }
+  if (std::find(this->m_OutputBufferPool.begin(), this->m_OutputBufferPool.end(), container) !=
+      this->m_OutputBufferPool.end())
+  {
+    return;
+  }
+  // Keep the largest buffers when there are more than the outputs can use.
+  this->m_OutputBufferPool.push_back(container);
+  const auto maximumSize = std::max<std::size_t>(this->GetNumberOfIndexedOutputs(), 1);
+  if (this->m_OutputBufferPool.size() > maximumSize)
+  {
+    auto smallest = std::min_element(this->m_OutputBufferPool.begin(),
+                                     this->m_OutputBufferPool.end(),
+                                     [](const auto & a, const auto & b) { return a->Capacity() < b->Capacity(); });
+    this->m_OutputBufferPool.erase(smallest);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::TakePooledOutputBuffer(
+  SizeValueType numberOfPixels) -> typename OutputPixelContainerType::Pointer
+{
+  auto best = this->m_OutputBufferPool.end();
+  for (auto it = this->m_OutputBufferPool.begin(); it != this->m_OutputBufferPool.end(); ++it)
+  {
+    if ((*it)->Capacity() >= numberOfPixels &&
+        (best == this->m_OutputBufferPool.end() || (*it)->Capacity() < (*best)->Capacity()))
+    {
+      best = it;
+    }
+  }
+  if (best == this->m_OutputBufferPool.end())
+  {
+    return nullptr;
+  }
+  typename OutputPixelContainerType::Pointer container = *best;
+  this->m_OutputBufferPool.erase(best);
+  return container;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SetComponentShift(unsigned int component,
+                                                                                      double       shift)
+{
+  if (this->GetComponentShift(component) == shift)
+  {
+    return;
+  }
+  if (component >= this->m_ComponentShifts.size())
+  {
+    this->m_ComponentShifts.resize(component + 1, 0.0);
+  }
+  this->m_ComponentShifts[component] = shift;
+  this->Modified();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+double
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComponentShift(unsigned int component) const
+{
+  return component < this->m_ComponentShifts.size() ? this->m_ComponentShifts[component] : 0.0;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SetComponentScale(unsigned int component,
+                                                                                      double       scale)
+{
+  if (this->GetComponentScale(component) == scale)
+  {
+    return;
+  }
+  if (component >= this->m_ComponentScales.size())
+  {
+    this->m_ComponentScales.resize(component + 1, 1.0);
+  }
+  this->m_ComponentScales[component] = scale;
+  this->Modified();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+double
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComponentScale(unsigned int component) const
+{
+  return component < this->m_ComponentScales.size() ? this->m_ComponentScales[component] : 1.0;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+const ComponentStatistics &
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComponentStatistics(
+  unsigned int component) const
+{
+  if (component >= this->m_ComponentStatistics.size() || this->m_SplitOutputs[component] == nullptr)
+  {
+    itkExceptionMacro("No statistics for component " << component << ", which the last update did not split with "
+                                                     << "ComputeStatistics on.");
+  }
+  return this->m_ComponentStatistics[component];
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GenerateOutputInformation()
+{
+  if constexpr (InputIsVectorImage)
+  {
+    const InputImageType * input = this->GetInput();
+    if (input)
+    {
+      const unsigned int numberOfComponents = input->GetNumberOfComponentsPerPixel();
+      const auto         numberOfOutputs = static_cast<unsigned int>(this->GetNumberOfIndexedOutputs());
+      this->SetNumberOfIndexedOutputs(numberOfComponents);
+      for (unsigned int i = numberOfOutputs; i < numberOfComponents; ++i)
+      {
+        this->SetNthOutput(i, this->MakeOutput(i));
+      }
+    }
+  }
+
+  Superclass::GenerateOutputInformation();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::UpdateOutputData(DataObject * output)
+{
+  if (!this->m_LazyComponents)
+  {
+    Superclass::UpdateOutputData(output);
+    return;
+  }
+
+  // The pipeline marks every output as generated once the filter executes;
+  // note those that will not be, to release them afterwards.
+  std::vector<DataObject *> staleOutputs;
+  for (DataObject * other : this->GetOutputs())
+  {
+    if (other && other != output &&
+        (other->GetDataReleased() || other->GetUpdateMTime() < other->GetPipelineMTime()))
+    {
+      staleOutputs.push_back(other);
+    }
+  }
+
+  this->m_LazyOutput = output;
+  try
+  {
+    Superclass::UpdateOutputData(output);
+  }
+  catch (...)
+  {
+    this->m_LazyOutput = nullptr;
+    throw;
+  }
+  this->m_LazyOutput = nullptr;
+
+  for (DataObject * other : staleOutputs)
+  {
+    other->ReleaseData();
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::PrepareOutputs()
+{
+  if (!this->m_ReuseOutputBuffers || this->m_FirstTouchOutputs)
+  {
+    // Pages placed by an earlier split are not reused for first touch.
+    this->m_OutputBufferPool.clear();
+  }
+  else
+  {
+    // Only the output refers to a buffer it is safe to take.  Supplied
+    // buffers are the caller's.
+    const auto numberOfComponents = static_cast<unsigned int>(this->GetNumberOfIndexedOutputs());
+    for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+    {
+      OutputImageType * outputPtr = this->GetOutput(ii);
+      if (!outputPtr || (this->m_LazyOutput && outputPtr != this->m_LazyOutput))
+      {
+        continue;
+      }
+      OutputPixelContainerType * container = outputPtr->GetPixelContainer();
+      if (container && container->GetReferenceCount() == 1 && container != this->GetOutputPixelContainer(ii))
+      {
+        this->RecycleOutputBuffer(container);
+      }
+    }
+  }
 
-  // Allocate the output memory as with ImageSource
-  unsigned int ii = 0;
-  for (OutputDataObjectIterator it(this); !it.IsAtEnd(); ++it, ++ii)
+  if (this->m_LazyOutput)
   {
-    // Check whether the output is an image of the appropriate
-    // dimension (use ProcessObject's version of the GetInput()
-    // method since it returns the input as a pointer to a
-    // DataObject as opposed to the subclass version which
-    // static_casts the input to an TInputImage).
-    outputPtr = dynamic_cast<ImageBaseType *>(it.GetOutput());
+    // Keep the outputs generated by earlier updates.
+    if (this->GetReleaseDataBeforeUpdateFlag())
+    {
+      this->m_LazyOutput->PrepareForNewData();
+    }
+    return;
+  }
+
+  Superclass::PrepareOutputs();
+}
+
 
-    if (outputPtr && this->m_ComponentsMask[ii])
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::AllocateOutputs()
+{
+  // Allocate the output memory as with ImageSource.  The outputs are looked
+  // up by index: iterating over the outputs visits them in the order of their
+  // names, which differs from the component order past ten components.
+  const auto numberOfComponents = static_cast<unsigned int>(this->GetNumberOfIndexedOutputs());
+  this->m_SplitOutputs.assign(numberOfComponents, nullptr);
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+  {
+    OutputImageType * outputPtr = this->GetOutput(ii);
+    if (!outputPtr || (this->m_LazyOutput && outputPtr != this->m_LazyOutput))
+    {
+      // In lazy mode, the other outputs keep what earlier updates generated.
+      continue;
+    }
+    if (this->GetComponentSelected(ii))
     {
       outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
-      outputPtr->Allocate();
+      OutputPixelContainerType * container = this->GetOutputPixelContainer(ii);
+      if (container)
+      {
+        const SizeValueType numberOfPixels = outputPtr->GetRequestedRegion().GetNumberOfPixels();
+        if (container->Size() != numberOfPixels)
+        {
+          itkExceptionMacro("The pixel container of component " << ii << " holds " << container->Size()
+                                                                << " pixels, but its requested region has "
+                                                                << numberOfPixels << '.');
+        }
+        outputPtr->SetPixelContainer(container);
+      }
+      else if (typename OutputPixelContainerType::Pointer pooled =
+                 this->m_FirstTouchOutputs
+                   ? nullptr
+                   : this->TakePooledOutputBuffer(outputPtr->GetRequestedRegion().GetNumberOfPixels()))
+      {
+        // A recycled buffer keeps the pages, and their placement, of the
+        // update that first wrote them.
+        outputPtr->SetPixelContainer(pooled);
+        outputPtr->Allocate();
+      }
+      else
+      {
+        // Do not reuse a buffer supplied for an earlier update, nor one whose
+        // pages are to be placed anew.
+        if (!outputPtr->GetPixelContainer()->GetContainerManageMemory() || this->m_FirstTouchOutputs)
+        {
+          outputPtr->SetPixelContainer(OutputPixelContainerType::New());
+        }
+        outputPtr->Allocate();
+      }
+      this->m_SplitOutputs[ii] = outputPtr;
+    }
+    else
+    {
+      // Free the buffer of a component that was selected by an earlier
+      // update instead of keeping stale data alive.
+      outputPtr->ReleaseData();
+    }
+  }
+
+  this->m_DerivedOutputs.assign(NumberOfDerivedOutputs, nullptr);
+  for (unsigned int ii = 0; ii < NumberOfDerivedOutputs; ++ii)
+  {
+    auto * derivedPtr =
+      itkDynamicCastInDebugMode<DerivedImageType *>(this->ProcessObject::GetOutput(GetDerivedOutputName(ii)));
+    if (!derivedPtr || (this->m_LazyOutput && derivedPtr != this->m_LazyOutput))
+    {
+      continue;
+    }
+    if (this->GetComputeDerivedOutput(ii))
+    {
+      derivedPtr->SetBufferedRegion(derivedPtr->GetRequestedRegion());
+      if (this->m_FirstTouchOutputs)
+      {
+        derivedPtr->SetPixelContainer(DerivedImageType::PixelContainer::New());
+      }
+      derivedPtr->Allocate();
+      this->m_DerivedOutputs[ii] = derivedPtr;
+    }
+    else
+    {
+      derivedPtr->ReleaseData();
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+auto
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetComponentView(unsigned int component) const
+  -> typename ComponentViewType::Pointer
+{
+  // The adaptor only reads the input, but its interface takes a non-const
+  // image.
+  auto * input = const_cast<InputImageType *>(this->GetInput());
+  if (input == nullptr)
+  {
+    itkExceptionMacro("Input image not set.");
+  }
+  unsigned int numberOfComponents = Components;
+  if constexpr (InputIsVectorImage)
+  {
+    numberOfComponents = input->GetNumberOfComponentsPerPixel();
+  }
+  if (component >= numberOfComponents)
+  {
+    itkExceptionMacro("Component " << component << " is out of range; the input has " << numberOfComponents
+                                   << " components.");
+  }
+
+  auto view = ComponentViewType::New();
+  view->SetImage(input);
+  if constexpr (InputIsVectorImage)
+  {
+    view->SetExtractComponentIndex(component);
+  }
+  else
+  {
+    view->SelectNthElement(component);
+  }
+  return view;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::BeforeThreadedGenerateData()
+{
+  const SizeValueType numberOfPixels = this->GetOutput()->GetRequestedRegion().GetNumberOfPixels();
+  SizeValueType       inputPixelSize = sizeof(InputPixelType);
+  if constexpr (InputIsVectorImage)
+  {
+    inputPixelSize = this->GetInput()->GetNumberOfComponentsPerPixel() * sizeof(InputComponentType);
+  }
+  const auto numberOfSplitOutputs =
+    std::count_if(this->m_SplitOutputs.begin(), this->m_SplitOutputs.end(), [](const OutputImageType * output) {
+      return output != nullptr;
+    });
+
+  // Set up the conversion of the components, unless they are all copied
+  // unchanged.
+  this->m_Conversions.clear();
+  const auto numberOfComponents = static_cast<unsigned int>(this->m_SplitOutputs.size());
+  bool       convert = this->m_ClampOutput;
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+  {
+    convert = convert || (this->m_SplitOutputs[ii] &&
+                          (this->GetComponentShift(ii) != 0.0 || this->GetComponentScale(ii) != 1.0));
+  }
+  if (convert)
+  {
+    if constexpr (CanConvertComponents)
+    {
+      // Casting an out of range value to an integral output is undefined,
+      // so the converted components of one are always clamped.
+      double outputLower = static_cast<double>(NumericTraits<OutputPixelType>::NonpositiveMin());
+      double outputUpper = static_cast<double>(NumericTraits<OutputPixelType>::max());
+      if constexpr (std::numeric_limits<OutputPixelType>::digits > std::numeric_limits<double>::digits)
+      {
+        // The maximum of a 64-bit integer rounds up to a double that is out
+        // of range.
+        outputUpper = std::nextafter(outputUpper, 0.0);
+      }
+      const bool clamp = this->m_ClampOutput || std::numeric_limits<OutputPixelType>::is_integer;
+      for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+      {
+        const double shift = this->GetComponentShift(ii);
+        const double scale = this->GetComponentScale(ii);
+        // Without ClampOutput, the components left unchanged are copied as
+        // by a plain split.
+        const bool clampComponent = clamp && (this->m_ClampOutput || shift != 0.0 || scale != 1.0);
+        this->m_Conversions.push_back({ shift,
+                                        scale,
+                                        clampComponent ? outputLower : -std::numeric_limits<double>::infinity(),
+                                        clampComponent ? outputUpper : std::numeric_limits<double>::infinity() });
+      }
+    }
+    else
+    {
+      itkExceptionMacro("Shifting, scaling or clamping components requires arithmetic input components and output "
+                        "pixels.");
     }
   }
+
+  this->m_ComponentStatistics.clear();
+  if (this->m_ComputeStatistics)
+  {
+    if constexpr (std::is_arithmetic_v<OutputPixelType>)
+    {
+      if (this->m_HistogramNumberOfBins > 0 &&
+          !(this->m_HistogramUpperBound > this->m_HistogramLowerBound &&
+            std::isfinite(this->m_HistogramUpperBound - this->m_HistogramLowerBound)))
+      {
+        itkExceptionMacro("The histogram range [" << this->m_HistogramLowerBound << ", "
+                                                  << this->m_HistogramUpperBound
+                                                  << "] is empty or too wide to be split into bins.");
+      }
+      this->m_ComponentStatistics.assign(
+        numberOfComponents,
+        ComponentStatistics(this->m_HistogramNumberOfBins, this->m_HistogramLowerBound, this->m_HistogramUpperBound));
+    }
+    else
+    {
+      itkExceptionMacro("Computing component statistics requires arithmetic output pixels.");
+    }
+  }
+
+  this->m_InputBytes = numberOfPixels * inputPixelSize;
+  const auto numberOfDerivedOutputs =
+    std::count_if(this->m_DerivedOutputs.begin(), this->m_DerivedOutputs.end(), [](const DerivedImageType * output) {
+      return output != nullptr;
+    });
+  this->m_OutputBytes = numberOfPixels * (numberOfSplitOutputs * sizeof(OutputPixelType) +
+                                          numberOfDerivedOutputs * sizeof(DerivedPixelType));
+  this->m_ElapsedTime = 0.0;
+  this->m_SlabTimes.clear();
+  this->m_StartTime = std::chrono::steady_clock::now();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+const ImageRegionSplitterBase *
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GetImageRegionSplitter() const
+{
+  return this->m_RegionSplitter;
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::GenerateData()
+{
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+
+  // Align the slabs to the cache lines of the first output that is split,
+  // measured from the address of its buffer.  The buffers of the other
+  // outputs are aligned alike when they are allocated alike, and otherwise
+  // only share a cache line at each slab boundary.
+  SizeValueType           alignment = 1;
+  SizeValueType           alignmentOffset = 0;
+  const OutputImageType * firstOutput = nullptr;
+  for (const OutputImageType * output : this->m_SplitOutputs)
+  {
+    if (output)
+    {
+      firstOutput = output;
+      break;
+    }
+  }
+  if (firstOutput && CacheLineSize % sizeof(OutputPixelType) == 0)
+  {
+    const auto addressOffset = reinterpret_cast<std::uintptr_t>(firstOutput->GetBufferPointer()) % CacheLineSize;
+    if (addressOffset % sizeof(OutputPixelType) == 0)
+    {
+      alignment = CacheLineSize / sizeof(OutputPixelType);
+      alignmentOffset = addressOffset / sizeof(OutputPixelType);
+    }
+  }
+  const OutputRegionType requestedRegion = this->GetOutput()->GetRequestedRegion();
+  const SizeValueType    bytesPerPixel =
+    (this->m_InputBytes + this->m_OutputBytes) / std::max<SizeValueType>(1, requestedRegion.GetNumberOfPixels());
+  this->m_RegionSplitter->SetAlignment(alignment);
+  this->m_RegionSplitter->SetAlignmentOffset(alignmentOffset);
+  this->m_RegionSplitter->SetPieceSize(SlabCacheSize / std::max<SizeValueType>(1, bytesPerPixel));
+
+  const unsigned int numberOfSlabs =
+    this->m_RegionSplitter->GetNumberOfSplits(requestedRegion, this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  if (this->m_FirstTouchOutputs)
+  {
+    // Touch the slabs with the same partition of the slabs into work units
+    // as the split below.  This counts as allocation, not as splitting.
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [this, &requestedRegion, numberOfSlabs](SizeValueType slab) {
+        OutputRegionType slabRegion = requestedRegion;
+        this->m_RegionSplitter->GetSplit(static_cast<unsigned int>(slab), numberOfSlabs, slabRegion);
+        for (unsigned int ii = 0; ii < this->m_SplitOutputs.size(); ++ii)
+        {
+          if (this->m_SplitOutputs[ii] && !this->GetOutputPixelContainer(ii))
+          {
+            TouchPages(this->m_SplitOutputs[ii], slabRegion);
+          }
+        }
+        for (DerivedImageType * derived : this->m_DerivedOutputs)
+        {
+          if (derived)
+          {
+            TouchPages(derived, slabRegion);
+          }
+        }
+      },
+      nullptr);
+    this->m_StartTime = std::chrono::steady_clock::now();
+  }
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [this, &requestedRegion, numberOfSlabs](SizeValueType slab) {
+      OutputRegionType slabRegion = requestedRegion;
+      this->m_RegionSplitter->GetSplit(static_cast<unsigned int>(slab), numberOfSlabs, slabRegion);
+      this->DynamicThreadedGenerateData(slabRegion);
+    },
+    this);
+
+  this->AfterThreadedGenerateData();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+template <typename TImage>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::TouchPages(TImage *                 image,
+                                                                               const OutputRegionType & region)
+{
+  using InternalPixelType = typename TImage::InternalPixelType;
+  InternalPixelType * const buffer = image->GetBufferPointer() + image->ComputeOffset(region.GetIndex());
+  const SizeValueType       numberOfPixels = region.GetNumberOfPixels();
+  const SizeValueType       pixelsPerPage = std::max<SizeValueType>(1, PageSize / sizeof(InternalPixelType));
+  for (SizeValueType ii = 0; ii < numberOfPixels; ii += pixelsPerPage)
+  {
+    buffer[ii] = InternalPixelType{};
+  }
 }
 
 
@@ -74,32 +858,304 @@ void
 SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::DynamicThreadedGenerateData(
   const OutputRegionType & outputRegion)
 {
-  typename InputImageType::ConstPointer input = this->GetInput();
-  ProcessObject::DataObjectPointerArray outputs = this->GetOutputs();
-  const ComponentsMaskType              componentsMask = this->m_ComponentsMask;
+  const auto start = std::chrono::steady_clock::now();
+
+  // Statistics of this slab, merged into those of the update at the
+  // end.
+  std::vector<ComponentStatistics> statistics;
+  if (this->m_ComputeStatistics)
+  {
+    statistics.assign(
+      this->m_ComponentStatistics.size(),
+      ComponentStatistics(this->m_HistogramNumberOfBins, this->m_HistogramLowerBound, this->m_HistogramUpperBound));
+  }
+
+  if constexpr (CanSplitScanlines)
+  {
+    this->SplitScanlines(outputRegion, statistics);
+  }
+  else
+  {
+    this->SplitPixels(outputRegion, statistics);
+  }
+
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const std::lock_guard<std::mutex>   lock(this->m_SlabMutex);
+  for (std::size_t ii = 0; ii < statistics.size(); ++ii)
+  {
+    this->m_ComponentStatistics[ii].Merge(statistics[ii]);
+  }
+  this->m_SlabTimes.push_back(elapsed.count());
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::AfterThreadedGenerateData()
+{
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - this->m_StartTime;
+  this->m_ElapsedTime = elapsed.count();
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SplitScanlines(
+  const OutputRegionType &           outputRegion,
+  std::vector<ComponentStatistics> & statistics)
+{
+  const InputImageType * input = this->GetInput();
+  const auto             numberOfComponents = static_cast<unsigned int>(this->m_SplitOutputs.size());
+  const SizeValueType    lineLength = outputRegion.GetSize(0);
+
+  // Number of components between consecutive pixels of the input buffer.
+  std::size_t                stride = 0;
+  const InputComponentType * inputBuffer = nullptr;
+  if constexpr (InputIsVectorImage)
+  {
+    stride = input->GetNumberOfComponentsPerPixel();
+    inputBuffer = input->GetBufferPointer();
+  }
+  else
+  {
+    stride = sizeof(InputPixelType) / sizeof(InputComponentType);
+    inputBuffer = reinterpret_cast<const InputComponentType *>(input->GetBufferPointer());
+  }
+
+  // Only the tensor measures generated by this update are computed, which
+  // in lazy mode may be fewer than those enabled.
+  bool computeTensorMeasures = false;
+  for (unsigned int ii = MagnitudeIndex + 1; ii < NumberOfDerivedOutputs; ++ii)
+  {
+    computeTensorMeasures = computeTensorMeasures || this->m_DerivedOutputs[ii] != nullptr;
+  }
+
+  // When some components are converted, the others are still copied by
+  // the vectorized kernels.
+  std::vector<bool> convertComponent(numberOfComponents, false);
+  bool              copyAnyComponent = this->m_Conversions.empty();
+  for (unsigned int ii = 0; ii < numberOfComponents && !this->m_Conversions.empty(); ++ii)
+  {
+    convertComponent[ii] = !SplitComponentsDetail::IsIdentityConversion(this->m_Conversions[ii]);
+    copyAnyComponent = copyAnyComponent || (this->m_SplitOutputs[ii] && !convertComponent[ii]);
+  }
+
+  std::vector<OutputPixelType *>  outputLines(numberOfComponents, nullptr);
+  std::vector<OutputPixelType *>  copiedLines(numberOfComponents, nullptr);
+  std::vector<OutputPixelType *>  convertedLines(numberOfComponents, nullptr);
+  std::vector<DerivedPixelType *> derivedLines(NumberOfDerivedOutputs, nullptr);
+  for (ImageScanlineConstIterator<InputImageType> inIt(input, outputRegion); !inIt.IsAtEnd(); inIt.NextLine())
+  {
+    const typename InputImageType::IndexType lineIndex = inIt.GetIndex();
+    for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+    {
+      OutputImageType * output = this->m_SplitOutputs[ii];
+      if (output)
+      {
+        outputLines[ii] = output->GetBufferPointer() + output->ComputeOffset(lineIndex);
+      }
+    }
+    for (unsigned int ii = 0; ii < NumberOfDerivedOutputs; ++ii)
+    {
+      DerivedImageType * derived = this->m_DerivedOutputs[ii];
+      if (derived)
+      {
+        derivedLines[ii] = derived->GetBufferPointer() + derived->ComputeOffset(lineIndex);
+      }
+    }
+    const InputComponentType * inputLine = inputBuffer + input->ComputeOffset(lineIndex) * stride;
+    if (this->m_Conversions.empty())
+    {
+      SplitComponentsDetail::DeinterleaveScanline(
+        inputLine, stride, lineLength, outputLines.data(), numberOfComponents);
+    }
+    else
+    {
+      for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+      {
+        copiedLines[ii] = convertComponent[ii] ? nullptr : outputLines[ii];
+        convertedLines[ii] = convertComponent[ii] ? outputLines[ii] : nullptr;
+      }
+      if (copyAnyComponent)
+      {
+        SplitComponentsDetail::DeinterleaveScanline(
+          inputLine, stride, lineLength, copiedLines.data(), numberOfComponents);
+      }
+      SplitComponentsDetail::ConvertScanline(
+        inputLine, stride, lineLength, this->m_Conversions.data(), convertedLines.data(), numberOfComponents);
+    }
+    // The lines just written, and the input line, are still in cache.
+    for (unsigned int ii = 0; ii < statistics.size(); ++ii)
+    {
+      if (outputLines[ii])
+      {
+        statistics[ii].Accumulate(outputLines[ii], lineLength);
+      }
+    }
+    if (derivedLines[MagnitudeIndex])
+    {
+      // Over all the components stored, which may be more than are split.
+      SplitComponentsDetail::MagnitudeScanline(
+        inputLine, stride, static_cast<unsigned int>(stride), lineLength, derivedLines[MagnitudeIndex]);
+    }
+    if constexpr (InputIsSymmetricTensor)
+    {
+      if (computeTensorMeasures)
+      {
+        const auto * pixels = reinterpret_cast<const InputPixelType *>(inputLine);
+        for (SizeValueType x = 0; x < lineLength; ++x)
+        {
+          this->ComputeTensorMeasures(pixels[x], derivedLines.data(), x);
+        }
+      }
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::SplitPixels(
+  const OutputRegionType &           outputRegion,
+  std::vector<ComponentStatistics> & statistics)
+{
+  const InputImageType * input = this->GetInput();
+  const auto             numberOfComponents = static_cast<unsigned int>(this->m_SplitOutputs.size());
 
   using OutputIteratorType = ImageRegionIterator<OutputImageType>;
   ImageRegionConstIterator<InputImageType> inIt(input, outputRegion);
-  std::vector<OutputIteratorType>          outIts(Components);
-  for (unsigned int ii = 0; ii < Components; ++ii)
+  std::vector<OutputIteratorType>          outIts(numberOfComponents);
+  for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
   {
-    if (componentsMask[ii])
+    if (this->m_SplitOutputs[ii])
     {
-      OutputIteratorType outIt(dynamic_cast<OutputImageType *>(outputs[ii].GetPointer()), outputRegion);
+      OutputIteratorType outIt(this->m_SplitOutputs[ii], outputRegion);
       outIt.GoToBegin();
       outIts[ii] = outIt;
     }
   }
+  // The derived outputs share the buffered region, so one offset addresses
+  // them all.
+  std::vector<DerivedPixelType *> derivedBuffers(NumberOfDerivedOutputs, nullptr);
+  const DerivedImageType *        derivedReference = nullptr;
+  for (unsigned int ii = 0; ii < NumberOfDerivedOutputs; ++ii)
+  {
+    if (this->m_DerivedOutputs[ii])
+    {
+      derivedBuffers[ii] = this->m_DerivedOutputs[ii]->GetBufferPointer();
+      derivedReference = this->m_DerivedOutputs[ii];
+    }
+  }
+
   InputPixelType inputPixel;
   for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
   {
     inputPixel = inIt.Get();
-    for (unsigned int ii = 0; ii < Components; ++ii)
+    if (derivedReference)
+    {
+      const OffsetValueType offset = derivedReference->ComputeOffset(inIt.GetIndex());
+      if constexpr (std::is_arithmetic_v<InputComponentType>)
+      {
+        if (derivedBuffers[MagnitudeIndex])
+        {
+          // Over all the components stored, which may be more than are split.
+          const unsigned int pixelLength = NumericTraits<InputPixelType>::GetLength(inputPixel);
+          double             sumOfSquares = 0.0;
+          for (unsigned int ii = 0; ii < pixelLength; ++ii)
+          {
+            const auto value = static_cast<double>(inputPixel[ii]);
+            sumOfSquares += value * value;
+          }
+          derivedBuffers[MagnitudeIndex][offset] = static_cast<DerivedPixelType>(std::sqrt(sumOfSquares));
+        }
+      }
+      if constexpr (InputIsSymmetricTensor)
+      {
+        this->ComputeTensorMeasures(inputPixel, derivedBuffers.data(), offset);
+      }
+    }
+    for (unsigned int ii = 0; ii < numberOfComponents; ++ii)
+    {
+      if (!this->m_SplitOutputs[ii])
+      {
+        continue;
+      }
+      OutputPixelType outputPixel;
+      if constexpr (CanConvertComponents)
+      {
+        outputPixel =
+          this->m_Conversions.empty()
+            ? static_cast<OutputPixelType>(inputPixel[ii])
+            : SplitComponentsDetail::ConvertValue<OutputPixelType>(inputPixel[ii], this->m_Conversions[ii]);
+      }
+      else
+      {
+        outputPixel = static_cast<OutputPixelType>(inputPixel[ii]);
+      }
+      outIts[ii].Set(outputPixel);
+      ++(outIts[ii]);
+      if constexpr (std::is_arithmetic_v<OutputPixelType>)
+      {
+        if (!statistics.empty())
+        {
+          statistics[ii].Accumulate(&outputPixel, 1);
+        }
+      }
+    }
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, unsigned int TComponents>
+void
+SplitComponentsImageFilter<TInputImage, TOutputImage, TComponents>::ComputeTensorMeasures(
+  const InputPixelType &     pixel,
+  DerivedPixelType * const * derived,
+  SizeValueType              offset) const
+{
+  if (derived[TraceIndex])
+  {
+    derived[TraceIndex][offset] = static_cast<DerivedPixelType>(pixel.GetTrace());
+  }
+
+  if (derived[FractionalAnisotropyIndex])
+  {
+    // The relative norm of the deviatoric part, as in
+    // DiffusionTensor3D::GetFractionalAnisotropy(), without the eigenvalues.
+    double trace = 0.0;
+    double squaredNorm = 0.0;
+    for (unsigned int i = 0; i < TensorDimension; ++i)
+    {
+      trace += pixel(i, i);
+      for (unsigned int j = 0; j < TensorDimension; ++j)
+      {
+        const auto value = static_cast<double>(pixel(i, j));
+        squaredNorm += value * value;
+      }
+    }
+    double fractionalAnisotropy = 0.0;
+    if (squaredNorm > 0.0 && TensorDimension > 1)
+    {
+      const double anisotropy = std::max(0.0, squaredNorm - trace * trace / TensorDimension);
+      fractionalAnisotropy = std::sqrt(TensorDimension / (TensorDimension - 1.0) * anisotropy / squaredNorm);
+    }
+    derived[FractionalAnisotropyIndex][offset] = static_cast<DerivedPixelType>(fractionalAnisotropy);
+  }
+
+  bool computeEigenValues = false;
+  for (unsigned int i = 0; i < TensorDimension; ++i)
+  {
+    computeEigenValues = computeEigenValues || derived[EigenValueIndex + i] != nullptr;
+  }
+  if (computeEigenValues)
+  {
+    typename InputPixelType::EigenValuesArrayType eigenValues;
+    pixel.ComputeEigenValues(eigenValues);
+    for (unsigned int i = 0; i < TensorDimension; ++i)
     {
-      if (componentsMask[ii])
+      if (derived[EigenValueIndex + i])
       {
-        outIts[ii].Set(static_cast<OutputPixelType>(inputPixel[ii]));
-        ++(outIts[ii]);
+        derived[EigenValueIndex + i][offset] = static_cast<DerivedPixelType>(eigenValues[i]);
       }
     }
   }
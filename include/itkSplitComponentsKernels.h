@@ -0,0 +1,802 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSplitComponentsKernels_h
+#define itkSplitComponentsKernels_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  define ITK_SPLITCOMPONENTS_X86_KERNELS
+#  include <immintrin.h>
+#endif
+
+namespace itk
+{
+namespace SplitComponentsDetail
+{
+
+/** Copy one component out of a scanline of interleaved pixels.
+ *
+ * \c input points to the first component of the first pixel of the line,
+ * \c stride is the number of components per pixel and \c length the number
+ * of pixels on the line. */
+template <typename TInputComponent, typename TOutput>
+inline void
+DeinterleaveComponent(const TInputComponent * input,
+                      std::size_t             stride,
+                      std::size_t             length,
+                      unsigned int            component,
+                      TOutput *               output)
+{
+  const TInputComponent * in = input + component;
+  for (std::size_t x = 0; x < length; ++x, in += stride)
+  {
+    output[x] = static_cast<TOutput>(*in);
+  }
+}
+
+
+/** As above with a stride known at compile time, which lets the compiler
+ * unroll and vectorize the gather. */
+template <unsigned int VStride, typename TInputComponent, typename TOutput>
+inline void
+DeinterleaveComponent(const TInputComponent * input, std::size_t length, unsigned int component, TOutput * output)
+{
+  const TInputComponent * in = input + component;
+  for (std::size_t x = 0; x < length; ++x)
+  {
+    output[x] = static_cast<TOutput>(in[x * VStride]);
+  }
+}
+
+
+#ifdef ITK_SPLITCOMPONENTS_X86_KERNELS
+
+/** Instruction sets the vectorized kernels can use on this CPU. */
+enum class SimdLevel
+{
+  None,
+  SSSE3,
+  AVX2
+};
+
+
+/** Detect the instruction set once, at first use. */
+inline SimdLevel
+GetSimdLevel()
+{
+  static const SimdLevel level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+      return SimdLevel::SSSE3;
+    }
+    return SimdLevel::None;
+  }();
+  return level;
+}
+
+
+/** Byte shuffle masks that gather one component out of a block of
+ * interleaved pixels.
+ *
+ * A block is \c VStride 16-byte vectors holding 16 / \c VElementSize pixels.
+ * Shuffling vector \c v with \c m_Masks[c][v] moves the bytes of component
+ * \c c that live in that vector to their place in the output vector and
+ * zeroes the rest, so OR-ing the \c VStride shuffles yields the component. */
+template <unsigned int VElementSize, unsigned int VStride>
+struct DeinterleaveShuffleMasks
+{
+  alignas(16) unsigned char m_Masks[VStride][VStride][16];
+
+  DeinterleaveShuffleMasks()
+  {
+    constexpr unsigned int pixelsPerBlock = 16 / VElementSize;
+    for (unsigned int c = 0; c < VStride; ++c)
+    {
+      for (unsigned int v = 0; v < VStride; ++v)
+      {
+        for (unsigned int pixel = 0; pixel < pixelsPerBlock; ++pixel)
+        {
+          for (unsigned int b = 0; b < VElementSize; ++b)
+          {
+            const unsigned int inputByte = (pixel * VStride + c) * VElementSize + b;
+            m_Masks[c][v][pixel * VElementSize + b] =
+              (inputByte / 16 == v) ? static_cast<unsigned char>(inputByte % 16) : 0x80;
+          }
+        }
+      }
+    }
+  }
+
+  static const DeinterleaveShuffleMasks &
+  Get()
+  {
+    static const DeinterleaveShuffleMasks masks;
+    return masks;
+  }
+};
+
+
+/** Deinterleave whole 16-byte blocks with SSSE3.  Returns the number of
+ * pixels processed; the caller finishes the remainder. */
+template <unsigned int VElementSize, unsigned int VStride>
+__attribute__((target("ssse3"))) std::size_t
+DeinterleaveBlocksSSSE3(const unsigned char *   input,
+                        std::size_t             length,
+                        unsigned char * const * outputs,
+                        unsigned int            numberOfOutputs)
+{
+  constexpr std::size_t pixelsPerBlock = 16 / VElementSize;
+  const auto &          masks = DeinterleaveShuffleMasks<VElementSize, VStride>::Get();
+
+  std::size_t x = 0;
+  for (; x + pixelsPerBlock <= length; x += pixelsPerBlock, input += 16 * VStride)
+  {
+    __m128i vectors[VStride];
+    for (unsigned int v = 0; v < VStride; ++v)
+    {
+      vectors[v] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 16 * v));
+    }
+    for (unsigned int c = 0; c < numberOfOutputs; ++c)
+    {
+      if (outputs[c] == nullptr)
+      {
+        continue;
+      }
+      __m128i component = _mm_setzero_si128();
+      for (unsigned int v = 0; v < VStride; ++v)
+      {
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.m_Masks[c][v]));
+        component = _mm_or_si128(component, _mm_shuffle_epi8(vectors[v], mask));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(outputs[c] + x * VElementSize), component);
+    }
+  }
+  return x;
+}
+
+
+/** Deinterleave pairs of 16-byte blocks with AVX2.  The byte shuffle works
+ * within 128-bit lanes, so two consecutive blocks are loaded into the low
+ * and high lanes and share the SSSE3 masks. */
+template <unsigned int VElementSize, unsigned int VStride>
+__attribute__((target("avx2"))) std::size_t
+DeinterleaveBlocksAVX2(const unsigned char *   input,
+                       std::size_t             length,
+                       unsigned char * const * outputs,
+                       unsigned int            numberOfOutputs)
+{
+  constexpr std::size_t pixelsPerBlock = 32 / VElementSize;
+  const auto &          masks = DeinterleaveShuffleMasks<VElementSize, VStride>::Get();
+
+  std::size_t x = 0;
+  for (; x + pixelsPerBlock <= length; x += pixelsPerBlock, input += 32 * VStride)
+  {
+    __m256i vectors[VStride];
+    for (unsigned int v = 0; v < VStride; ++v)
+    {
+      const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 16 * v));
+      const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 16 * (VStride + v)));
+      vectors[v] = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    }
+    for (unsigned int c = 0; c < numberOfOutputs; ++c)
+    {
+      if (outputs[c] == nullptr)
+      {
+        continue;
+      }
+      __m256i component = _mm256_setzero_si256();
+      for (unsigned int v = 0; v < VStride; ++v)
+      {
+        const __m256i mask =
+          _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(masks.m_Masks[c][v])));
+        component = _mm256_or_si256(component, _mm256_shuffle_epi8(vectors[v], mask));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(outputs[c] + x * VElementSize), component);
+    }
+  }
+  return x;
+}
+
+
+template <unsigned int VElementSize, unsigned int VStride>
+std::size_t
+DeinterleaveBlocks(const unsigned char *   input,
+                   std::size_t             length,
+                   unsigned char * const * outputs,
+                   unsigned int            numberOfOutputs)
+{
+  switch (GetSimdLevel())
+  {
+    case SimdLevel::AVX2:
+    {
+      const std::size_t done = DeinterleaveBlocksAVX2<VElementSize, VStride>(input, length, outputs, numberOfOutputs);
+      unsigned char *   remainingOutputs[VStride];
+      for (unsigned int c = 0; c < numberOfOutputs; ++c)
+      {
+        remainingOutputs[c] = outputs[c] ? outputs[c] + done * VElementSize : nullptr;
+      }
+      return done + DeinterleaveBlocksSSSE3<VElementSize, VStride>(
+                      input + done * VStride * VElementSize, length - done, remainingOutputs, numberOfOutputs);
+    }
+    case SimdLevel::SSSE3:
+      return DeinterleaveBlocksSSSE3<VElementSize, VStride>(input, length, outputs, numberOfOutputs);
+    default:
+      return 0;
+  }
+}
+
+#endif // ITK_SPLITCOMPONENTS_X86_KERNELS
+
+
+/** Deinterleave as many pixels as the vectorized kernels handle for this
+ * layout, and return how many that was.
+ *
+ * Kernels exist for 1, 2 and 4 byte components, strides of 2, 3, 4 and 6
+ * components, and outputs of the input component type. */
+template <typename TInputComponent, typename TOutput>
+std::size_t
+DeinterleaveVectorized(const TInputComponent * input,
+                       std::size_t             stride,
+                       std::size_t             length,
+                       TOutput * const *       outputs,
+                       unsigned int            numberOfOutputs)
+{
+#ifdef ITK_SPLITCOMPONENTS_X86_KERNELS
+  constexpr std::size_t elementSize = sizeof(TOutput);
+  if constexpr (std::is_same_v<TInputComponent, TOutput> && (elementSize == 1 || elementSize == 2 || elementSize == 4))
+  {
+    constexpr unsigned int maximumStride = 6;
+    if (numberOfOutputs > stride || stride > maximumStride)
+    {
+      return 0;
+    }
+    const auto *    bytes = reinterpret_cast<const unsigned char *>(input);
+    unsigned char * byteOutputs[maximumStride];
+    for (unsigned int c = 0; c < numberOfOutputs; ++c)
+    {
+      byteOutputs[c] = reinterpret_cast<unsigned char *>(outputs[c]);
+    }
+    switch (stride)
+    {
+      case 2:
+        return DeinterleaveBlocks<elementSize, 2>(bytes, length, byteOutputs, numberOfOutputs);
+      case 3:
+        return DeinterleaveBlocks<elementSize, 3>(bytes, length, byteOutputs, numberOfOutputs);
+      case 4:
+        return DeinterleaveBlocks<elementSize, 4>(bytes, length, byteOutputs, numberOfOutputs);
+      case 6:
+        return DeinterleaveBlocks<elementSize, 6>(bytes, length, byteOutputs, numberOfOutputs);
+      default:
+        return 0;
+    }
+  }
+#endif
+  (void)input;
+  (void)stride;
+  (void)length;
+  (void)outputs;
+  (void)numberOfOutputs;
+  return 0;
+}
+
+
+/** Split a scanline of interleaved pixels into per-component scanlines.
+ *
+ * \c outputs holds \c numberOfOutputs pointers; component \c c is written to
+ * \c outputs[c] unless that pointer is null.  \c stride is the number of
+ * components per input pixel, which may exceed \c numberOfOutputs, e.g. when
+ * only the RGB channels of an RGBA pixel are split.
+ *
+ * Layouts with a vectorized kernel for the running CPU go through it; the
+ * rest of the line, or all of it for other layouts, is copied by scalar
+ * loops. */
+template <typename TInputComponent, typename TOutput>
+void
+DeinterleaveScanline(const TInputComponent * input,
+                     std::size_t             stride,
+                     std::size_t             length,
+                     TOutput * const *       outputs,
+                     unsigned int            numberOfOutputs)
+{
+  const std::size_t done = DeinterleaveVectorized(input, stride, length, outputs, numberOfOutputs);
+  input += done * stride;
+  length -= done;
+  if (length == 0)
+  {
+    return;
+  }
+
+  for (unsigned int c = 0; c < numberOfOutputs; ++c)
+  {
+    if (outputs[c] == nullptr)
+    {
+      continue;
+    }
+    TOutput * output = outputs[c] + done;
+    switch (stride)
+    {
+      case 2:
+        DeinterleaveComponent<2>(input, length, c, output);
+        break;
+      case 3:
+        DeinterleaveComponent<3>(input, length, c, output);
+        break;
+      case 4:
+        DeinterleaveComponent<4>(input, length, c, output);
+        break;
+      case 6:
+        DeinterleaveComponent<6>(input, length, c, output);
+        break;
+      default:
+        DeinterleaveComponent(input, stride, length, c, output);
+        break;
+    }
+  }
+}
+
+
+/** Parameters of the conversion applied to a component as it is split:
+ * the output is (input + shift) * scale, clamped to [lower, upper]. */
+struct ComponentConversion
+{
+  double shift;
+  double scale;
+  double lower;
+  double upper;
+};
+
+
+/** Whether a conversion leaves the components unchanged, but for the cast
+ * to the output type. */
+inline bool
+IsIdentityConversion(const ComponentConversion & conversion)
+{
+  return conversion.shift == 0.0 && conversion.scale == 1.0 &&
+         conversion.lower == -std::numeric_limits<double>::infinity() &&
+         conversion.upper == std::numeric_limits<double>::infinity();
+}
+
+
+/** Clamp a converted value to [lower, upper] and cast it to the output
+ * type.  A NaN passes through to a floating point output, and is mapped to
+ * 0 for an integral one, whose bounds must then be within its range. */
+template <typename TOutput>
+inline TOutput
+ClampAndCast(double value, double lower, double upper)
+{
+  if constexpr (std::numeric_limits<TOutput>::is_integer)
+  {
+    value = value == value ? value : 0.0;
+  }
+  return static_cast<TOutput>(std::min(std::max(value, lower), upper));
+}
+
+
+/** Convert a single component. */
+template <typename TOutput, typename TInputComponent>
+inline TOutput
+ConvertValue(TInputComponent input, const ComponentConversion & conversion)
+{
+  const double value = (static_cast<double>(input) + conversion.shift) * conversion.scale;
+  return ClampAndCast<TOutput>(value, conversion.lower, conversion.upper);
+}
+
+
+/** Copy one component out of a scanline of interleaved pixels, converting
+ * it on the way.  The arithmetic is branch free, so the loop vectorizes to
+ * packed multiplies, min/max, blends and conversions. */
+template <typename TInputComponent, typename TOutput>
+inline void
+ConvertComponent(const TInputComponent *     input,
+                 std::size_t                 stride,
+                 std::size_t                 length,
+                 unsigned int                component,
+                 const ComponentConversion & conversion,
+                 TOutput *                   output)
+{
+  const TInputComponent * in = input + component;
+  const double            shift = conversion.shift;
+  const double            scale = conversion.scale;
+  const double            lower = conversion.lower;
+  const double            upper = conversion.upper;
+  for (std::size_t x = 0; x < length; ++x, in += stride)
+  {
+    const double value = (static_cast<double>(*in) + shift) * scale;
+    output[x] = ClampAndCast<TOutput>(value, lower, upper);
+  }
+}
+
+
+/** As above with a stride known at compile time. */
+template <unsigned int VStride, typename TInputComponent, typename TOutput>
+inline void
+ConvertComponent(const TInputComponent *     input,
+                 std::size_t                 length,
+                 unsigned int                component,
+                 const ComponentConversion & conversion,
+                 TOutput *                   output)
+{
+  const TInputComponent * in = input + component;
+  const double            shift = conversion.shift;
+  const double            scale = conversion.scale;
+  const double            lower = conversion.lower;
+  const double            upper = conversion.upper;
+  for (std::size_t x = 0; x < length; ++x)
+  {
+    const double value = (static_cast<double>(in[x * VStride]) + shift) * scale;
+    output[x] = ClampAndCast<TOutput>(value, lower, upper);
+  }
+}
+
+
+/** Split a scanline of interleaved pixels into per-component scanlines,
+ * converting component \c c with \c conversions[c].  Otherwise as
+ * DeinterleaveScanline(). */
+template <typename TInputComponent, typename TOutput>
+void
+ConvertScanline(const TInputComponent *     input,
+                std::size_t                 stride,
+                std::size_t                 length,
+                const ComponentConversion * conversions,
+                TOutput * const *           outputs,
+                unsigned int                numberOfOutputs)
+{
+  for (unsigned int c = 0; c < numberOfOutputs; ++c)
+  {
+    if (outputs[c] == nullptr)
+    {
+      continue;
+    }
+    switch (stride)
+    {
+      case 2:
+        ConvertComponent<2>(input, length, c, conversions[c], outputs[c]);
+        break;
+      case 3:
+        ConvertComponent<3>(input, length, c, conversions[c], outputs[c]);
+        break;
+      case 4:
+        ConvertComponent<4>(input, length, c, conversions[c], outputs[c]);
+        break;
+      case 6:
+        ConvertComponent<6>(input, length, c, conversions[c], outputs[c]);
+        break;
+      default:
+        ConvertComponent(input, stride, length, c, conversions[c], outputs[c]);
+        break;
+    }
+  }
+}
+
+
+/** Euclidean norm of the first \c numberOfComponents components of each
+ * pixel of a scanline of interleaved pixels. */
+template <typename TInputComponent, typename TOutput>
+inline void
+MagnitudeScanline(const TInputComponent * input,
+                  std::size_t             stride,
+                  unsigned int            numberOfComponents,
+                  std::size_t             length,
+                  TOutput *               output)
+{
+  for (std::size_t x = 0; x < length; ++x, input += stride)
+  {
+    double sumOfSquares = 0.0;
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      const auto value = static_cast<double>(input[c]);
+      sumOfSquares += value * value;
+    }
+    output[x] = static_cast<TOutput>(std::sqrt(sumOfSquares));
+  }
+}
+
+
+/** Write one component into a scanline of interleaved pixels; the inverse
+ * of DeinterleaveComponent.  A null \c input writes zeros. */
+template <typename TInput, typename TOutputComponent>
+inline void
+InterleaveComponent(const TInput *     input,
+                    std::size_t        length,
+                    unsigned int       component,
+                    std::size_t        stride,
+                    TOutputComponent * output)
+{
+  TOutputComponent * out = output + component;
+  if (input == nullptr)
+  {
+    for (std::size_t x = 0; x < length; ++x, out += stride)
+    {
+      *out = TOutputComponent{};
+    }
+    return;
+  }
+  for (std::size_t x = 0; x < length; ++x, out += stride)
+  {
+    *out = static_cast<TOutputComponent>(input[x]);
+  }
+}
+
+
+/** As above with a stride known at compile time. */
+template <unsigned int VStride, typename TInput, typename TOutputComponent>
+inline void
+InterleaveComponent(const TInput * input, std::size_t length, unsigned int component, TOutputComponent * output)
+{
+  TOutputComponent * out = output + component;
+  if (input == nullptr)
+  {
+    for (std::size_t x = 0; x < length; ++x)
+    {
+      out[x * VStride] = TOutputComponent{};
+    }
+    return;
+  }
+  for (std::size_t x = 0; x < length; ++x)
+  {
+    out[x * VStride] = static_cast<TOutputComponent>(input[x]);
+  }
+}
+
+
+#ifdef ITK_SPLITCOMPONENTS_X86_KERNELS
+
+/** Byte shuffle masks that scatter component scanlines into a block of
+ * interleaved pixels; the inverse of DeinterleaveShuffleMasks.
+ *
+ * Shuffling the 16-byte vector of component \c c with \c m_Masks[v][c]
+ * places its bytes that belong in output vector \c v and zeroes the rest,
+ * so OR-ing the shuffles of all components yields output vector \c v. */
+template <unsigned int VElementSize, unsigned int VStride>
+struct InterleaveShuffleMasks
+{
+  alignas(16) unsigned char m_Masks[VStride][VStride][16];
+
+  InterleaveShuffleMasks()
+  {
+    for (unsigned int v = 0; v < VStride; ++v)
+    {
+      for (unsigned int c = 0; c < VStride; ++c)
+      {
+        for (unsigned int byte = 0; byte < 16; ++byte)
+        {
+          const unsigned int outputByte = 16 * v + byte;
+          const unsigned int element = outputByte / VElementSize;
+          const unsigned int inputByte = (element / VStride) * VElementSize + outputByte % VElementSize;
+          m_Masks[v][c][byte] = (element % VStride == c) ? static_cast<unsigned char>(inputByte) : 0x80;
+        }
+      }
+    }
+  }
+
+  static const InterleaveShuffleMasks &
+  Get()
+  {
+    static const InterleaveShuffleMasks masks;
+    return masks;
+  }
+};
+
+
+/** Interleave whole 16-byte blocks with SSSE3.  Null inputs yield zeros.
+ * Returns the number of pixels processed. */
+template <unsigned int VElementSize, unsigned int VStride>
+__attribute__((target("ssse3"))) std::size_t
+InterleaveBlocksSSSE3(const unsigned char * const * inputs, std::size_t length, unsigned char * output)
+{
+  constexpr std::size_t pixelsPerBlock = 16 / VElementSize;
+  const auto &          masks = InterleaveShuffleMasks<VElementSize, VStride>::Get();
+
+  std::size_t x = 0;
+  for (; x + pixelsPerBlock <= length; x += pixelsPerBlock, output += 16 * VStride)
+  {
+    __m128i vectors[VStride];
+    for (unsigned int c = 0; c < VStride; ++c)
+    {
+      vectors[c] = inputs[c] ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(inputs[c] + x * VElementSize))
+                             : _mm_setzero_si128();
+    }
+    for (unsigned int v = 0; v < VStride; ++v)
+    {
+      __m128i interleaved = _mm_setzero_si128();
+      for (unsigned int c = 0; c < VStride; ++c)
+      {
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.m_Masks[v][c]));
+        interleaved = _mm_or_si128(interleaved, _mm_shuffle_epi8(vectors[c], mask));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16 * v), interleaved);
+    }
+  }
+  return x;
+}
+
+
+/** Interleave pairs of 16-byte blocks with AVX2, one block per 128-bit
+ * lane. */
+template <unsigned int VElementSize, unsigned int VStride>
+__attribute__((target("avx2"))) std::size_t
+InterleaveBlocksAVX2(const unsigned char * const * inputs, std::size_t length, unsigned char * output)
+{
+  constexpr std::size_t pixelsPerBlock = 32 / VElementSize;
+  const auto &          masks = InterleaveShuffleMasks<VElementSize, VStride>::Get();
+
+  std::size_t x = 0;
+  for (; x + pixelsPerBlock <= length; x += pixelsPerBlock, output += 32 * VStride)
+  {
+    __m256i vectors[VStride];
+    for (unsigned int c = 0; c < VStride; ++c)
+    {
+      vectors[c] = inputs[c] ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(inputs[c] + x * VElementSize))
+                             : _mm256_setzero_si256();
+    }
+    for (unsigned int v = 0; v < VStride; ++v)
+    {
+      __m256i interleaved = _mm256_setzero_si256();
+      for (unsigned int c = 0; c < VStride; ++c)
+      {
+        const __m256i mask =
+          _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(masks.m_Masks[v][c])));
+        interleaved = _mm256_or_si256(interleaved, _mm256_shuffle_epi8(vectors[c], mask));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16 * v), _mm256_castsi256_si128(interleaved));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16 * (VStride + v)),
+                       _mm256_extracti128_si256(interleaved, 1));
+    }
+  }
+  return x;
+}
+
+
+template <unsigned int VElementSize, unsigned int VStride>
+std::size_t
+InterleaveBlocks(const unsigned char * const * inputs, std::size_t length, unsigned char * output)
+{
+  switch (GetSimdLevel())
+  {
+    case SimdLevel::AVX2:
+    {
+      const std::size_t     done = InterleaveBlocksAVX2<VElementSize, VStride>(inputs, length, output);
+      const unsigned char * remainingInputs[VStride];
+      for (unsigned int c = 0; c < VStride; ++c)
+      {
+        remainingInputs[c] = inputs[c] ? inputs[c] + done * VElementSize : nullptr;
+      }
+      return done + InterleaveBlocksSSSE3<VElementSize, VStride>(
+                      remainingInputs, length - done, output + done * VStride * VElementSize);
+    }
+    case SimdLevel::SSSE3:
+      return InterleaveBlocksSSSE3<VElementSize, VStride>(inputs, length, output);
+    default:
+      return 0;
+  }
+}
+
+#endif // ITK_SPLITCOMPONENTS_X86_KERNELS
+
+
+/** Interleave as many pixels as the vectorized kernels handle for this
+ * layout, and return how many that was.  The same layouts as for
+ * DeinterleaveVectorized are covered. */
+template <typename TInput, typename TOutputComponent>
+std::size_t
+InterleaveVectorized(const TInput * const * inputs,
+                     unsigned int           numberOfInputs,
+                     std::size_t            length,
+                     TOutputComponent *     output,
+                     std::size_t            stride)
+{
+#ifdef ITK_SPLITCOMPONENTS_X86_KERNELS
+  constexpr std::size_t elementSize = sizeof(TOutputComponent);
+  if constexpr (std::is_same_v<TInput, TOutputComponent> && (elementSize == 1 || elementSize == 2 || elementSize == 4))
+  {
+    constexpr unsigned int maximumStride = 6;
+    if (numberOfInputs > stride || stride > maximumStride)
+    {
+      return 0;
+    }
+    // Components past the inputs are zeroed like those of null inputs.
+    const unsigned char * byteInputs[maximumStride] = {};
+    for (unsigned int c = 0; c < numberOfInputs; ++c)
+    {
+      byteInputs[c] = reinterpret_cast<const unsigned char *>(inputs[c]);
+    }
+    auto * bytes = reinterpret_cast<unsigned char *>(output);
+    switch (stride)
+    {
+      case 2:
+        return InterleaveBlocks<elementSize, 2>(byteInputs, length, bytes);
+      case 3:
+        return InterleaveBlocks<elementSize, 3>(byteInputs, length, bytes);
+      case 4:
+        return InterleaveBlocks<elementSize, 4>(byteInputs, length, bytes);
+      case 6:
+        return InterleaveBlocks<elementSize, 6>(byteInputs, length, bytes);
+      default:
+        return 0;
+    }
+  }
+#endif
+  (void)inputs;
+  (void)numberOfInputs;
+  (void)length;
+  (void)output;
+  (void)stride;
+  return 0;
+}
+
+
+/** Interleave per-component scanlines into a scanline of pixels; the
+ * inverse of DeinterleaveScanline.
+ *
+ * Component \c c of each output pixel is read from \c inputs[c].  Null
+ * inputs, and components past \c numberOfInputs when \c stride is larger,
+ * are set to zero. */
+template <typename TInput, typename TOutputComponent>
+void
+InterleaveScanline(const TInput * const * inputs,
+                   unsigned int           numberOfInputs,
+                   std::size_t            length,
+                   TOutputComponent *     output,
+                   std::size_t            stride)
+{
+  const std::size_t done = InterleaveVectorized(inputs, numberOfInputs, length, output, stride);
+  output += done * stride;
+  length -= done;
+  if (length == 0)
+  {
+    return;
+  }
+
+  for (unsigned int c = 0; c < stride; ++c)
+  {
+    const TInput * input = (c < numberOfInputs && inputs[c]) ? inputs[c] + done : nullptr;
+    switch (stride)
+    {
+      case 2:
+        InterleaveComponent<2>(input, length, c, output);
+        break;
+      case 3:
+        InterleaveComponent<3>(input, length, c, output);
+        break;
+      case 4:
+        InterleaveComponent<4>(input, length, c, output);
+        break;
+      case 6:
+        InterleaveComponent<6>(input, length, c, output);
+        break;
+      default:
+        InterleaveComponent(input, length, c, stride, output);
+        break;
+    }
+  }
+}
+
+} // end namespace SplitComponentsDetail
+} // end namespace itk
+
+#endif
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAlignedImageRegionSplitter.h"
+#include "itkImageRegion.h"
+
+#include <iostream>
+
+namespace
+{
+
+// Split a region and check that the slabs are whole slices of its slowest
+// dimension, in order, that they cover it, and, when expected, that each but
+// the first starts at an aligned address of a buffer whose alignment offset
+// is given.
+template <unsigned int VDimension>
+int
+CheckSplit(const char *                         name,
+           const itk::ImageRegion<VDimension> & region,
+           itk::SizeValueType                   alignment,
+           itk::SizeValueType                   alignmentOffset,
+           itk::SizeValueType                   pieceSize,
+           unsigned int                         requestedNumber,
+           unsigned int                         expectedNumber,
+           bool                                 expectAligned)
+{
+  auto splitter = itk::AlignedImageRegionSplitter::New();
+  splitter->SetAlignment(alignment);
+  splitter->SetAlignmentOffset(alignmentOffset);
+  splitter->SetPieceSize(pieceSize);
+
+  const unsigned int numberOfSlabs = splitter->GetNumberOfSplits(region, requestedNumber);
+  if (numberOfSlabs != expectedNumber)
+  {
+    std::cerr << name << ": " << numberOfSlabs << " slabs instead of " << expectedNumber << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  unsigned int splitDimension = VDimension - 1;
+  while (splitDimension > 0 && region.GetSize(splitDimension) == 1)
+  {
+    --splitDimension;
+  }
+  itk::SizeValueType sliceSize = 1;
+  for (unsigned int d = 0; d < splitDimension; ++d)
+  {
+    sliceSize *= region.GetSize(d);
+  }
+
+  itk::IndexValueType next = region.GetIndex(splitDimension);
+  for (unsigned int i = 0; i < numberOfSlabs; ++i)
+  {
+    itk::ImageRegion<VDimension> slab = region;
+    splitter->GetSplit(i, numberOfSlabs, slab);
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (d != splitDimension && (slab.GetIndex(d) != region.GetIndex(d) || slab.GetSize(d) != region.GetSize(d)))
+      {
+        std::cerr << name << ": slab " << i << " is not made of whole slices: " << slab << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (slab.GetIndex(splitDimension) != next || slab.GetSize(splitDimension) == 0)
+    {
+      std::cerr << name << ": slab " << i << " does not follow the previous one: " << slab << std::endl;
+      return EXIT_FAILURE;
+    }
+    const auto offset =
+      alignmentOffset + static_cast<itk::SizeValueType>(next - region.GetIndex(splitDimension)) * sliceSize;
+    if (expectAligned && i > 0 && offset % alignment != 0)
+    {
+      std::cerr << name << ": slab " << i << " starts at offset " << offset << ", not a multiple of " << alignment
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    next += static_cast<itk::IndexValueType>(slab.GetSize(splitDimension));
+  }
+  if (next != region.GetIndex(splitDimension) + static_cast<itk::IndexValueType>(region.GetSize(splitDimension)))
+  {
+    std::cerr << name << ": the slabs do not cover the region" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+
+int
+itkAlignedImageRegionSplitterTest(int, char *[])
+{
+  using RegionType = itk::ImageRegion<3>;
+
+  RegionType::IndexType index = { { 3, -2, 5 } };
+  RegionType::SizeType  size = { { 37, 11, 29 } };
+  const RegionType      volume(index, size);
+
+  int result = EXIT_SUCCESS;
+
+  // Slices of 407 pixels are only aligned to 32 pixels every 32 slices, more
+  // than a slab, so the odd volume is split into unaligned slabs, as many as
+  // requested.
+  result |= CheckSplit("odd slices", volume, 32, 0, 0, 4, 4, false);
+  result |= CheckSplit("requested", volume, 1, 0, 0, 8, 8, false);
+  result |= CheckSplit("piece size", volume, 1, 0, 4 * 407, 2, 8, false);
+  // No more slabs than slices.
+  size = { { 37, 11, 3 } };
+  result |= CheckSplit("few slices", RegionType(index, size), 32, 0, 0, 8, 3, false);
+  // Slices of 48 pixels in a buffer 16 pixels past a 32 pixel boundary start
+  // aligned every other slice.
+  size = { { 12, 4, 40 } };
+  result |= CheckSplit("aligned slices", RegionType(index, size), 32, 16, 0, 4, 4, true);
+  // With an offset of 8 pixels no slice starts aligned.
+  result |= CheckSplit("unalignable slices", RegionType(index, size), 32, 8, 0, 4, 4, false);
+  // A single slice is split into rows; rows of 12 pixels are aligned to 16
+  // pixels every 4 rows.
+  size = { { 12, 37, 1 } };
+  result |= CheckSplit("single slice", RegionType(index, size), 16, 0, 0, 5, 5, true);
+  result |= CheckSplit("single work unit", volume, 16, 0, 0, 1, 1, false);
+
+  return result;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkRGBAPixel.h"
+#include "itkVector.h"
+#include "itkVectorImage.h"
+
+#include "itkInterleaveComponentsImageFilter.h"
+#include "itkSplitComponentsImageFilter.h"
+
+namespace
+{
+
+// Split an image and interleave the components back; the result must match
+// the original, with the component skipped by the mask set to zero.
+template <typename TImage, typename TComponentImage, unsigned int VComponents>
+int
+RoundTrip(const char * name, unsigned int numberOfComponents, unsigned int skippedComponent)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+  using ComponentType = typename TComponentImage::PixelType;
+
+  auto                      input = TImage::New();
+  typename TImage::SizeType size;
+  size.Fill(9);
+  size[0] = 45;
+  input->SetRegions(size);
+  input->SetNumberOfComponentsPerPixel(numberOfComponents);
+  input->Allocate();
+
+  ComponentType *    buffer = reinterpret_cast<ComponentType *>(input->GetBufferPointer());
+  itk::SizeValueType numberOfValues = numberOfComponents;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    numberOfValues *= size[d];
+  }
+  for (itk::SizeValueType i = 0; i < numberOfValues; ++i)
+  {
+    buffer[i] = static_cast<ComponentType>(1 + i % 113);
+  }
+
+  using SplitType = itk::SplitComponentsImageFilter<TImage, TComponentImage, VComponents>;
+  auto split = SplitType::New();
+  split->SetInput(input);
+
+  using InterleaveType = itk::InterleaveComponentsImageFilter<TComponentImage, TImage, VComponents>;
+  auto                                        interleave = InterleaveType::New();
+  typename InterleaveType::ComponentsMaskType componentsMask(true);
+  if (skippedComponent < VComponents)
+  {
+    componentsMask[skippedComponent] = false;
+  }
+  interleave->SetComponentsMask(componentsMask);
+
+  try
+  {
+    split->UpdateOutputInformation();
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      if (c != skippedComponent)
+      {
+        interleave->SetComponent(c, split->GetOutput(c));
+      }
+    }
+    interleave->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << name << ": exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const TImage * output = interleave->GetOutput();
+  if (InterleaveType::OutputIsVectorImage && output->GetNumberOfComponentsPerPixel() != numberOfComponents)
+  {
+    std::cerr << name << ": expected " << numberOfComponents << " components, got "
+              << output->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+  }
+  const ComponentType * result = reinterpret_cast<const ComponentType *>(output->GetBufferPointer());
+  for (itk::SizeValueType i = 0; i < numberOfValues; ++i)
+  {
+    const ComponentType expected = (i % numberOfComponents == skippedComponent) ? ComponentType{} : buffer[i];
+    if (result[i] != expected)
+    {
+      std::cerr << name << ": value " << i << " is " << static_cast<double>(result[i]) << " instead of "
+                << static_cast<double>(expected) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+int
+itkInterleaveComponentsImageFilterTest(int, char *[])
+{
+  constexpr unsigned int none = 100;
+
+  using RGBAImageType = itk::Image<itk::RGBAPixel<unsigned char>, 2>;
+  using UCharImageType = itk::Image<unsigned char, 2>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+  using FloatImageType = itk::Image<float, 3>;
+  using ShortVectorImageType = itk::VectorImage<short, 2>;
+  using ShortImageType = itk::Image<short, 2>;
+
+  int result = EXIT_SUCCESS;
+
+  result |= RoundTrip<RGBAImageType, UCharImageType, 4>("RGBA uchar", 4, none);
+  result |= RoundTrip<RGBAImageType, UCharImageType, 4>("RGBA uchar, masked", 4, 3);
+  result |= RoundTrip<VectorImageType, FloatImageType, 3>("Vector float 3", 3, none);
+  result |= RoundTrip<VectorImageType, FloatImageType, 3>("Vector float 3, masked", 3, 0);
+  result |= RoundTrip<ShortVectorImageType, ShortImageType, 2>("VectorImage short 7", 7, none);
+
+  return result;
+}
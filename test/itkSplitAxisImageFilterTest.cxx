@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkCommand.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "itkSplitAxisImageFilter.h"
+
+#include <iostream>
+
+namespace
+{
+
+using PixelType = short;
+using InputImageType = itk::Image<PixelType, 3>;
+using OutputImageType = itk::Image<PixelType, 2>;
+using FilterType = itk::SplitAxisImageFilter<InputImageType, OutputImageType>;
+
+// Check that the output of a selected slice holds the input pixels at that
+// offset along the axis, and that the others are released.
+int
+CheckSlices(const char * name, const InputImageType * input, FilterType * filter)
+{
+  const unsigned int axis = filter->GetAxis();
+  if (filter->GetNumberOfSlices() != input->GetLargestPossibleRegion().GetSize(axis))
+  {
+    std::cerr << name << ": " << filter->GetNumberOfSlices() << " outputs instead of "
+              << input->GetLargestPossibleRegion().GetSize(axis) << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned int slice = 0; slice < filter->GetNumberOfSlices(); ++slice)
+  {
+    const OutputImageType * output = filter->GetOutput(slice);
+    if (!filter->GetSliceSelected(slice))
+    {
+      if (output->GetBufferPointer() != nullptr)
+      {
+        std::cerr << name << ": slice " << slice << " was not selected but is allocated" << std::endl;
+        return EXIT_FAILURE;
+      }
+      continue;
+    }
+    itk::ImageRegionConstIteratorWithIndex<OutputImageType> it(output, output->GetLargestPossibleRegion());
+    for (; !it.IsAtEnd(); ++it)
+    {
+      InputImageType::IndexType index;
+      for (unsigned int d = 0, o = 0; d < 3; ++d)
+      {
+        index[d] = d == axis ? input->GetLargestPossibleRegion().GetIndex(axis) + slice : it.GetIndex()[o++];
+      }
+      if (it.Get() != input->GetPixel(index))
+      {
+        std::cerr << name << ": slice " << slice << " differs from the input at " << index << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+
+int
+itkSplitAxisImageFilterTest(int, char *[])
+{
+  InputImageType::IndexType index = { { 2, -1, 3 } };
+  InputImageType::SizeType  size = { { 7, 5, 4 } };
+  auto                      input = InputImageType::New();
+  input->SetRegions(InputImageType::RegionType(index, size));
+  input->Allocate();
+  itk::ImageRegionIteratorWithIndex<InputImageType> it(input, input->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    index = it.GetIndex();
+    it.Set(static_cast<PixelType>(index[0] + 10 * index[1] + 100 * index[2]));
+  }
+
+  int result = EXIT_SUCCESS;
+
+  // Along the slowest axis, the outputs view the input buffer.
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  try
+  {
+    filter->UpdateOutputInformation();
+    filter->GetOutput(2)->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  result |= CheckSlices("slowest axis", input, filter);
+  if (filter->GetOutput(2)->GetBufferPointer() != input->GetBufferPointer() + 2 * size[0] * size[1])
+  {
+    std::cerr << "slowest axis: the output does not view the input buffer" << std::endl;
+    result = EXIT_FAILURE;
+  }
+
+  // Along another axis, the selected slices are copied.
+  auto copyFilter = FilterType::New();
+  copyFilter->SetInput(input);
+  copyFilter->SetAxis(0);
+  copyFilter->SetSelectedSlices({ 1, 4 });
+  try
+  {
+    copyFilter->UpdateOutputInformation();
+    copyFilter->GetOutput(4)->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  result |= CheckSlices("fastest axis", input, copyFilter);
+  if (copyFilter->GetOutput(1)->GetSpacing()[0] != input->GetSpacing()[1] ||
+      copyFilter->GetOutput(1)->GetLargestPossibleRegion().GetSize(1) != size[2])
+  {
+    std::cerr << "fastest axis: the axis was not dropped from the output information" << std::endl;
+    result = EXIT_FAILURE;
+  }
+
+  // A view outlives the filter and the input, and keeps the input buffer
+  // alive until it is released itself.
+  OutputImageType::Pointer frame;
+  bool                     inputBufferDeleted = false;
+  {
+    auto viewedInput = InputImageType::New();
+    viewedInput->SetRegions(size);
+    viewedInput->Allocate();
+    viewedInput->FillBuffer(7);
+    viewedInput->GetPixelContainer()->AddObserver(
+      itk::DeleteEvent(), [&inputBufferDeleted](const itk::EventObject &) { inputBufferDeleted = true; });
+    auto viewFilter = FilterType::New();
+    viewFilter->SetInput(viewedInput);
+    try
+    {
+      viewFilter->UpdateOutputInformation();
+      viewFilter->GetOutput(1)->Update();
+    }
+    catch (itk::ExceptionObject & ex)
+    {
+      std::cerr << "Exception caught!" << std::endl;
+      std::cerr << ex << std::endl;
+      return EXIT_FAILURE;
+    }
+    frame = viewFilter->GetOutput(1);
+  }
+  if (inputBufferDeleted)
+  {
+    std::cerr << "released filter: the input buffer was deleted under the view" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionConstIterator<OutputImageType> frameIt(frame, frame->GetLargestPossibleRegion());
+  for (; !frameIt.IsAtEnd(); ++frameIt)
+  {
+    if (frameIt.Get() != 7)
+    {
+      std::cerr << "released filter: the view differs from the input" << std::endl;
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+  frame = nullptr;
+  if (!inputBufferDeleted)
+  {
+    std::cerr << "released filter: the input buffer outlives its last view" << std::endl;
+    result = EXIT_FAILURE;
+  }
+
+  return result;
+}
@@ -0,0 +1,395 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Throughput benchmark for SplitComponentsImageFilter.
+//
+// Times the filter over pixel types, component layouts, image dimensions,
+// image sizes, numbers of work units and component masks, and prints one
+// record per case in CSV or JSON lines so runs can be compared across
+// commits.  Run with --help for the options.
+
+#include "itkCovariantVector.h"
+#include "itkImage.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRGBAPixel.h"
+#include "itkRGBPixel.h"
+#include "itkTimeProbe.h"
+#include "itkVector.h"
+#include "itkVectorImage.h"
+
+#include "itkSplitComponentsImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+  std::vector<itk::SizeValueType> sizes{ 32 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024 };
+  std::vector<unsigned int>       workUnits;
+  std::vector<std::string>        masks{ "all", "first", "even" };
+  unsigned int                    repetitions = 5;
+  std::string                     format = "csv";
+  std::string                     match;
+};
+
+
+struct Record
+{
+  std::string        name;
+  std::string        component;
+  unsigned int       components;
+  unsigned int       dimension;
+  std::string        mask;
+  itk::SizeValueType inputBytes;
+  itk::SizeValueType outputBytes;
+  unsigned int       workUnits;
+  unsigned int       repetitions;
+  double             minimumSeconds;
+  double             meanSeconds;
+};
+
+
+void
+PrintHeader(const Options & options)
+{
+  if (options.format == "csv")
+  {
+    std::cout << "case,component,components,dimension,mask,input_bytes,output_bytes,work_units,repetitions,"
+                 "min_seconds,mean_seconds,gb_per_second"
+              << std::endl;
+  }
+}
+
+
+void
+PrintRecord(const Options & options, const Record & record)
+{
+  // Bytes read plus bytes written, over the fastest repetition.
+  const double gbPerSecond =
+    static_cast<double>(record.inputBytes + record.outputBytes) / record.minimumSeconds / 1.0e9;
+  if (options.format == "json")
+  {
+    std::cout << "{\"case\": \"" << record.name << "\", \"component\": \"" << record.component
+              << "\", \"components\": " << record.components << ", \"dimension\": " << record.dimension
+              << ", \"mask\": \"" << record.mask << "\", \"input_bytes\": " << record.inputBytes
+              << ", \"output_bytes\": " << record.outputBytes << ", \"work_units\": " << record.workUnits
+              << ", \"repetitions\": " << record.repetitions << ", \"min_seconds\": " << record.minimumSeconds
+              << ", \"mean_seconds\": " << record.meanSeconds << ", \"gb_per_second\": " << gbPerSecond << "}"
+              << std::endl;
+  }
+  else
+  {
+    std::cout << record.name << ',' << record.component << ',' << record.components << ',' << record.dimension << ','
+              << record.mask << ',' << record.inputBytes << ',' << record.outputBytes << ',' << record.workUnits << ','
+              << record.repetitions << ',' << record.minimumSeconds << ',' << record.meanSeconds << ',' << gbPerSecond
+              << std::endl;
+  }
+}
+
+
+std::vector<unsigned int>
+MaskComponents(const std::string & mask, unsigned int numberOfComponents)
+{
+  std::vector<unsigned int> components;
+  for (unsigned int c = 0; c < numberOfComponents; ++c)
+  {
+    if (mask == "all" || (mask == "first" && c == 0) || (mask == "even" && c % 2 == 0))
+    {
+      components.push_back(c);
+    }
+  }
+  return components;
+}
+
+
+// Time one layout for every size, number of work units and mask.
+template <typename TInputImage, typename TComponent, unsigned int VComponents>
+void
+Benchmark(const Options &     options,
+          const std::string & name,
+          const std::string & componentName,
+          unsigned int        numberOfComponents)
+{
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+  using OutputImageType = itk::Image<TComponent, Dimension>;
+  using FilterType = itk::SplitComponentsImageFilter<TInputImage, OutputImageType, VComponents>;
+
+  for (const itk::SizeValueType bytes : options.sizes)
+  {
+    // A cube, or square, of about the requested number of input bytes.
+    const double pixels = static_cast<double>(bytes) / (numberOfComponents * sizeof(TComponent));
+    const auto   side = std::max<itk::SizeValueType>(
+      1, static_cast<itk::SizeValueType>(std::pow(pixels, 1.0 / static_cast<double>(Dimension))));
+
+    typename TInputImage::SizeType size;
+    size.Fill(side);
+    auto input = TInputImage::New();
+    input->SetRegions(size);
+    input->SetNumberOfComponentsPerPixel(numberOfComponents);
+    input->Allocate();
+    const itk::SizeValueType numberOfPixels = input->GetLargestPossibleRegion().GetNumberOfPixels();
+    auto *                   buffer = reinterpret_cast<TComponent *>(input->GetBufferPointer());
+    for (itk::SizeValueType i = 0; i < numberOfPixels * numberOfComponents; ++i)
+    {
+      buffer[i] = static_cast<TComponent>(i % 97);
+    }
+
+    for (const unsigned int workUnits : options.workUnits)
+    {
+      for (const std::string & mask : options.masks)
+      {
+        const std::vector<unsigned int> components = MaskComponents(mask, numberOfComponents);
+
+        auto filter = FilterType::New();
+        filter->SetInput(input);
+        filter->SetNumberOfWorkUnits(workUnits);
+        filter->SetSelectedComponents(components);
+
+        // Untimed warm-up: allocates the outputs and faults their pages.
+        filter->Update();
+
+        itk::TimeProbe probe;
+        for (unsigned int r = 0; r < options.repetitions; ++r)
+        {
+          filter->Modified();
+          probe.Start();
+          filter->Update();
+          probe.Stop();
+        }
+
+        Record record;
+        record.name = name;
+        record.component = componentName;
+        record.components = numberOfComponents;
+        record.dimension = Dimension;
+        record.mask = mask;
+        record.inputBytes = numberOfPixels * numberOfComponents * sizeof(TComponent);
+        record.outputBytes = numberOfPixels * components.size() * sizeof(TComponent);
+        record.workUnits = workUnits;
+        record.repetitions = options.repetitions;
+        record.minimumSeconds = probe.GetMinimum();
+        record.meanSeconds = probe.GetMean();
+        PrintRecord(options, record);
+      }
+    }
+  }
+}
+
+
+struct Case
+{
+  std::string                          name;
+  std::function<void(const Options &)> run;
+};
+
+
+template <typename TComponent, unsigned int VDimension>
+void
+AddVectorCases(std::vector<Case> & cases, const std::string & componentName)
+{
+  const std::string dimension = std::to_string(VDimension) + "D";
+  cases.push_back({ "Vector2_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::Vector<TComponent, 2>, VDimension>, TComponent, 2>(
+                       options, "Vector2_" + dimension, componentName, 2);
+                   } });
+  cases.push_back({ "Vector3_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::Vector<TComponent, 3>, VDimension>, TComponent, 3>(
+                       options, "Vector3_" + dimension, componentName, 3);
+                   } });
+  cases.push_back({ "CovariantVector3_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::CovariantVector<TComponent, 3>, VDimension>, TComponent, 3>(
+                       options, "CovariantVector3_" + dimension, componentName, 3);
+                   } });
+  cases.push_back({ "Vector4_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::Vector<TComponent, 4>, VDimension>, TComponent, 4>(
+                       options, "Vector4_" + dimension, componentName, 4);
+                   } });
+  cases.push_back({ "Vector5_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::Vector<TComponent, 5>, VDimension>, TComponent, 5>(
+                       options, "Vector5_" + dimension, componentName, 5);
+                   } });
+  cases.push_back({ "Vector6_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::Vector<TComponent, 6>, VDimension>, TComponent, 6>(
+                       options, "Vector6_" + dimension, componentName, 6);
+                   } });
+  cases.push_back({ "VectorImage3_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::VectorImage<TComponent, VDimension>, TComponent, 1>(
+                       options, "VectorImage3_" + dimension, componentName, 3);
+                   } });
+  cases.push_back({ "VectorImage32_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::VectorImage<TComponent, VDimension>, TComponent, 1>(
+                       options, "VectorImage32_" + dimension, componentName, 32);
+                   } });
+}
+
+
+template <typename TComponent, unsigned int VDimension>
+void
+AddColorCases(std::vector<Case> & cases, const std::string & componentName)
+{
+  const std::string dimension = std::to_string(VDimension) + "D";
+  cases.push_back({ "RGB_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::RGBPixel<TComponent>, VDimension>, TComponent, 3>(
+                       options, "RGB_" + dimension, componentName, 3);
+                   } });
+  cases.push_back({ "RGBA_" + componentName + "_" + dimension, [=](const Options & options) {
+                     Benchmark<itk::Image<itk::RGBAPixel<TComponent>, VDimension>, TComponent, 4>(
+                       options, "RGBA_" + dimension, componentName, 4);
+                   } });
+}
+
+
+template <typename T>
+std::vector<T>
+ParseList(const std::string & list)
+{
+  std::vector<T>     values;
+  std::istringstream stream(list);
+  std::string        item;
+  while (std::getline(stream, item, ','))
+  {
+    std::istringstream itemStream(item);
+    T                  value;
+    itemStream >> value;
+    values.push_back(value);
+  }
+  return values;
+}
+
+
+void
+PrintUsage(const char * program)
+{
+  std::cerr << "Usage: " << program << " [options]\n"
+            << "  --sizes B1,B2,...       input sizes in bytes (default 32768,4194304,67108864)\n"
+            << "  --work-units N1,N2,...  numbers of work units (default 1 and the default of the filter)\n"
+            << "  --masks M1,M2,...       component masks among all, first, even (default all of them)\n"
+            << "  --repetitions R         timed updates per case (default 5)\n"
+            << "  --format csv|json       output format (default csv)\n"
+            << "  --match SUBSTRING       only run the cases whose name contains SUBSTRING\n"
+            << "  --list                  list the cases and exit" << std::endl;
+}
+
+} // end anonymous namespace
+
+
+int
+main(int argc, char * argv[])
+{
+  Options options;
+  bool    list = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string argument = argv[i];
+    const bool        hasValue = i + 1 < argc;
+    if (argument == "--sizes" && hasValue)
+    {
+      options.sizes = ParseList<itk::SizeValueType>(argv[++i]);
+    }
+    else if (argument == "--work-units" && hasValue)
+    {
+      options.workUnits = ParseList<unsigned int>(argv[++i]);
+    }
+    else if (argument == "--masks" && hasValue)
+    {
+      options.masks = ParseList<std::string>(argv[++i]);
+    }
+    else if (argument == "--repetitions" && hasValue)
+    {
+      options.repetitions = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (argument == "--format" && hasValue)
+    {
+      options.format = argv[++i];
+    }
+    else if (argument == "--match" && hasValue)
+    {
+      options.match = argv[++i];
+    }
+    else if (argument == "--list")
+    {
+      list = true;
+    }
+    else
+    {
+      PrintUsage(argv[0]);
+      return argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (options.workUnits.empty())
+  {
+    options.workUnits.push_back(1);
+    const unsigned int defaultWorkUnits = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+    if (defaultWorkUnits > 1)
+    {
+      options.workUnits.push_back(defaultWorkUnits);
+    }
+  }
+
+  std::vector<Case> cases;
+  AddColorCases<unsigned char, 2>(cases, "uchar");
+  AddColorCases<unsigned char, 3>(cases, "uchar");
+  AddColorCases<unsigned short, 2>(cases, "ushort");
+  AddColorCases<unsigned short, 3>(cases, "ushort");
+  AddVectorCases<unsigned char, 2>(cases, "uchar");
+  AddVectorCases<unsigned char, 3>(cases, "uchar");
+  AddVectorCases<short, 2>(cases, "short");
+  AddVectorCases<short, 3>(cases, "short");
+  AddVectorCases<float, 2>(cases, "float");
+  AddVectorCases<float, 3>(cases, "float");
+  AddVectorCases<double, 2>(cases, "double");
+  AddVectorCases<double, 3>(cases, "double");
+
+  if (!list)
+  {
+    PrintHeader(options);
+  }
+  for (const Case & benchmarkCase : cases)
+  {
+    if (benchmarkCase.name.find(options.match) == std::string::npos)
+    {
+      continue;
+    }
+    if (list)
+    {
+      std::cout << benchmarkCase.name << std::endl;
+      continue;
+    }
+    try
+    {
+      benchmarkCase.run(options);
+    }
+    catch (itk::ExceptionObject & ex)
+    {
+      std::cerr << benchmarkCase.name << ": exception caught!" << std::endl;
+      std::cerr << ex << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
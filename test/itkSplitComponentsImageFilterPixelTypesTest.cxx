@@ -0,0 +1,717 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDiffusionTensor3D.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkRGBAPixel.h"
+#include "itkRGBPixel.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkVector.h"
+#include "itkVectorImage.h"
+
+#include "itkSplitComponentsImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+// Split a 3D image whose rows are not a multiple of the vector width, so
+// both the vectorized kernels and their scalar remainder are exercised, and
+// compare every output against the input components.
+template <typename TPixel, typename TOutputPixel, unsigned int VComponents>
+int
+SplitAndCompare(const char * name, unsigned int skippedComponent)
+{
+  constexpr unsigned int Dimension = 3;
+  using InputImageType = itk::Image<TPixel, Dimension>;
+  using OutputImageType = itk::Image<TOutputPixel, Dimension>;
+  using ComponentType = typename TPixel::ValueType;
+  constexpr unsigned int pixelLength = sizeof(TPixel) / sizeof(ComponentType);
+
+  auto                              input = InputImageType::New();
+  typename InputImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 11;
+  size[2] = 5;
+  input->SetRegions(size);
+  input->Allocate();
+
+  unsigned int                             value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  {
+    TPixel pixel;
+    for (unsigned int c = 0; c < pixelLength; ++c)
+    {
+      pixel[c] = static_cast<ComponentType>(value++ % 251);
+    }
+    inIt.Set(pixel);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, VComponents>;
+  auto                                    filter = FilterType::New();
+  typename FilterType::ComponentsMaskType componentsMask(true);
+  if (skippedComponent < VComponents)
+  {
+    componentsMask[skippedComponent] = false;
+  }
+  filter->SetComponentsMask(componentsMask);
+  filter->SetInput(input);
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << name << ": exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int c = 0; c < VComponents; ++c)
+  {
+    if (!componentsMask[c])
+    {
+      continue;
+    }
+    itk::ImageRegionConstIterator<InputImageType>  expectedIt(input, input->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<OutputImageType> outIt(filter->GetOutput(c), input->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++outIt)
+    {
+      if (outIt.Get() != static_cast<TOutputPixel>(expectedIt.Get()[c]))
+      {
+        std::cerr << name << ": component " << c << " differs at " << outIt.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// Split a VectorImage with more components than the default TComponents;
+// the filter creates one output per component at run time.
+template <typename TComponent>
+int
+SplitVectorImageAndCompare(const char * name, unsigned int numberOfComponents)
+{
+  constexpr unsigned int Dimension = 2;
+  using InputImageType = itk::VectorImage<TComponent, Dimension>;
+  using OutputImageType = itk::Image<TComponent, Dimension>;
+
+  auto                              input = InputImageType::New();
+  typename InputImageType::SizeType size;
+  size[0] = 53;
+  size[1] = 7;
+  input->SetRegions(size);
+  input->SetNumberOfComponentsPerPixel(numberOfComponents);
+  input->Allocate();
+
+  TComponent * buffer = input->GetBufferPointer();
+  for (itk::SizeValueType i = 0; i < input->GetPixelContainer()->Size(); ++i)
+  {
+    buffer[i] = static_cast<TComponent>(i % 127);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType>;
+  auto                                    filter = FilterType::New();
+  typename FilterType::ComponentsMaskType componentsMask(true);
+  componentsMask[0] = false;
+  filter->SetComponentsMask(componentsMask);
+  filter->SetInput(input);
+
+  try
+  {
+    filter->UpdateOutputInformation();
+    if (filter->GetNumberOfIndexedOutputs() != numberOfComponents)
+    {
+      std::cerr << name << ": expected " << numberOfComponents << " outputs, got "
+                << filter->GetNumberOfIndexedOutputs() << std::endl;
+      return EXIT_FAILURE;
+    }
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << name << ": exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int c = 1; c < numberOfComponents; ++c)
+  {
+    const TComponent * expected = buffer + c;
+    const TComponent * output = filter->GetOutput(c)->GetBufferPointer();
+    for (itk::SizeValueType i = 0; i < size[0] * size[1]; ++i, expected += numberOfComponents)
+    {
+      if (output[i] != *expected)
+      {
+        std::cerr << name << ": component " << c << " differs at offset " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// Split float vectors into unsigned char with a shift and scale per
+// component, clamped to [0, 255] within the split.
+int
+ConvertAndCompare()
+{
+  constexpr unsigned int Dimension = 2;
+  using InputImageType = itk::Image<itk::Vector<float, 3>, Dimension>;
+  using OutputImageType = itk::Image<unsigned char, Dimension>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 9;
+  input->SetRegions(size);
+  input->Allocate();
+
+  float                                    value = -300.0f;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  {
+    InputImageType::PixelType pixel;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      pixel[c] = value;
+      value += 1.75f;
+    }
+    inIt.Set(pixel);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 3>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetComponentShift(0, 100.0);
+  filter->SetComponentScale(1, 0.5);
+  filter->SetComponentShift(2, -10.0);
+  filter->SetComponentScale(2, 2.0);
+  filter->ClampOutputOn();
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Conversion: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    itk::ImageRegionConstIterator<InputImageType>  expectedIt(input, input->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<OutputImageType> outIt(filter->GetOutput(c), input->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++outIt)
+    {
+      const double converted =
+        (expectedIt.Get()[c] + filter->GetComponentShift(c)) * filter->GetComponentScale(c);
+      const auto expected = static_cast<unsigned char>(std::min(255.0, std::max(0.0, converted)));
+      if (outIt.Get() != expected)
+      {
+        std::cerr << "Conversion: component " << c << " differs at " << outIt.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// Shift and scale the middle component without ClampOutput.  The others
+// are copied bit for bit, NaN included, and an integral output is still
+// clamped, with NaN mapped to 0.
+template <typename TOutput>
+int
+ConvertOneAndCompare(const char * name)
+{
+  constexpr unsigned int Dimension = 2;
+  using InputImageType = itk::Image<itk::Vector<float, 3>, Dimension>;
+  using OutputImageType = itk::Image<TOutput, Dimension>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 11;
+  input->SetRegions(size);
+  input->Allocate();
+
+  constexpr bool                           IntegralOutput = std::numeric_limits<TOutput>::is_integer;
+  unsigned int                             value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++value)
+  {
+    InputImageType::PixelType pixel;
+    // Within the range of an integral output, which a plain split requires.
+    pixel[0] = static_cast<float>(value % 256);
+    pixel[2] = static_cast<float>((value * 7) % 256) + (IntegralOutput ? 0.0f : 0.25f);
+    pixel[1] = static_cast<float>(value) * 3.5f - 600.0f;
+    if (value % 13 == 0)
+    {
+      pixel[1] = std::numeric_limits<float>::quiet_NaN();
+      if constexpr (!IntegralOutput)
+      {
+        pixel[0] = std::numeric_limits<float>::quiet_NaN();
+        pixel[2] = -std::numeric_limits<float>::infinity();
+      }
+    }
+    inIt.Set(pixel);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 3>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetComponentShift(1, 0.5);
+  filter->SetComponentScale(1, 3.0);
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << name << ": exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    itk::ImageRegionConstIterator<InputImageType>  expectedIt(input, input->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<OutputImageType> outIt(filter->GetOutput(c), input->GetLargestPossibleRegion());
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++outIt)
+    {
+      const float component = expectedIt.Get()[c];
+      TOutput     expected = static_cast<TOutput>(component);
+      if (c == 1)
+      {
+        const double converted = (static_cast<double>(component) + 0.5) * 3.0;
+        if constexpr (IntegralOutput)
+        {
+          const auto lower = static_cast<double>(std::numeric_limits<TOutput>::lowest());
+          const auto upper = static_cast<double>(std::numeric_limits<TOutput>::max());
+          expected = std::isnan(converted) ? TOutput{ 0 } : static_cast<TOutput>(std::clamp(converted, lower, upper));
+        }
+        else
+        {
+          expected = static_cast<TOutput>(converted);
+        }
+      }
+      const TOutput output = outIt.Get();
+      if (std::memcmp(&output, &expected, sizeof(TOutput)) != 0)
+      {
+        std::cerr << name << ": component " << c << " differs at " << outIt.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// Compute the statistics of the components while splitting them over
+// several work units, and compare them with those of the whole outputs.
+int
+ComputeStatisticsAndCompare()
+{
+  constexpr unsigned int Dimension = 3;
+  using InputImageType = itk::Image<itk::Vector<short, 3>, Dimension>;
+  using OutputImageType = itk::Image<short, Dimension>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  // Large enough to be split into several slabs by the slab size alone.
+  size[0] = 61;
+  size[1] = 47;
+  size[2] = 53;
+  input->SetRegions(size);
+  input->Allocate();
+
+  int                                      value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  {
+    InputImageType::PixelType pixel;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      pixel[c] = static_cast<short>((value * 7919LL) % 2000 - 1000);
+      ++value;
+    }
+    inIt.Set(pixel);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 3>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetComponentSelected(1, false);
+  filter->SetNumberOfWorkUnits(4);
+  filter->ComputeStatisticsOn();
+  filter->SetHistogramNumberOfBins(10);
+  filter->SetHistogramLowerBound(-500.0);
+  filter->SetHistogramUpperBound(500.0);
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Statistics: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Each slab accumulates its own statistics, which are then merged.
+  if (filter->GetNumberOfExecutedSlabs() < 2)
+  {
+    std::cerr << "Statistics: the image was split into " << filter->GetNumberOfExecutedSlabs()
+              << " slab, so no statistics were merged." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (const unsigned int c : { 0u, 2u })
+  {
+    const OutputImageType *  output = filter->GetOutput(c);
+    const itk::SizeValueType count = output->GetBufferedRegion().GetNumberOfPixels();
+    itk::ComponentStatistics expected(10, -500.0, 500.0);
+    expected.Accumulate(output->GetBufferPointer(), count);
+
+    const itk::ComponentStatistics & statistics = filter->GetComponentStatistics(c);
+    if (statistics.GetCount() != count || statistics.GetMinimum() != expected.GetMinimum() ||
+        statistics.GetMaximum() != expected.GetMaximum() ||
+        std::abs(statistics.GetMean() - expected.GetMean()) > 1e-9 ||
+        std::abs(statistics.GetVariance() - expected.GetVariance()) > 1e-6 * expected.GetVariance() ||
+        statistics.GetHistogram() != expected.GetHistogram())
+    {
+      std::cerr << "Statistics: component " << c << " differs from those of its output." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The deselected component has no statistics.
+  try
+  {
+    filter->GetComponentStatistics(1);
+    std::cerr << "Statistics: expected an exception for a deselected component." << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (itk::ExceptionObject &)
+  {
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// A double output has no histogram by default, rejects one over its whole
+// range, whose width overflows, and bins one over a range that is set.
+int
+ComputeDoubleStatisticsAndCompare()
+{
+  constexpr unsigned int Dimension = 2;
+  using InputImageType = itk::Image<itk::Vector<double, 2>, Dimension>;
+  using OutputImageType = itk::Image<double, Dimension>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  size[0] = 31;
+  size[1] = 17;
+  input->SetRegions(size);
+  input->Allocate();
+
+  unsigned int                             value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt, ++value)
+  {
+    InputImageType::PixelType pixel;
+    pixel[0] = static_cast<double>(value % 101) * 0.01 - 0.5;
+    pixel[1] = static_cast<double>(value) * -1.5;
+    inIt.Set(pixel);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->ComputeStatisticsOn();
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Double statistics: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  const itk::SizeValueType count = input->GetLargestPossibleRegion().GetNumberOfPixels();
+  if (filter->GetComponentStatistics(0).GetCount() != count ||
+      !filter->GetComponentStatistics(0).GetHistogram().empty())
+  {
+    std::cerr << "Double statistics: expected no histogram by default." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  filter->SetHistogramNumberOfBins(8);
+  filter->SetHistogramLowerBound(std::numeric_limits<double>::lowest());
+  filter->SetHistogramUpperBound(std::numeric_limits<double>::max());
+  try
+  {
+    filter->Update();
+    std::cerr << "Double statistics: expected an exception for the whole range of double." << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (itk::ExceptionObject &)
+  {
+  }
+
+  filter->SetHistogramLowerBound(-0.5);
+  filter->SetHistogramUpperBound(0.5);
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Double statistics: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  const OutputImageType *  output = filter->GetOutput(0);
+  itk::ComponentStatistics expected(8, -0.5, 0.5);
+  expected.Accumulate(output->GetBufferPointer(), count);
+  const itk::ComponentStatistics::HistogramType & histogram = filter->GetComponentStatistics(0).GetHistogram();
+  if (histogram != expected.GetHistogram() || histogram.front() == count)
+  {
+    std::cerr << "Double statistics: unexpected histogram." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// Compute the derived outputs of diffusion tensors alongside their
+// components, and compare them with the measures of DiffusionTensor3D.
+int
+DeriveAndCompare()
+{
+  constexpr unsigned int Dimension = 3;
+  using TensorType = itk::DiffusionTensor3D<float>;
+  using InputImageType = itk::Image<TensorType, Dimension>;
+  using OutputImageType = itk::Image<float, Dimension>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  size[0] = 19;
+  size[1] = 5;
+  size[2] = 3;
+  input->SetRegions(size);
+  input->Allocate();
+
+  unsigned int                             value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  {
+    TensorType tensor;
+    for (unsigned int c = 0; c < 6; ++c)
+    {
+      tensor[c] = static_cast<float>((value++ * 37) % 23) / 23.0f - 0.3f;
+    }
+    inIt.Set(tensor);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType, 6>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->ComputeMagnitudeOn();
+  filter->ComputeTraceOn();
+  filter->ComputeFractionalAnisotropyOn();
+  filter->ComputeEigenValuesOn();
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Derived outputs: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using DerivedImageType = FilterType::DerivedImageType;
+  const auto                                      region = input->GetLargestPossibleRegion();
+  itk::ImageRegionConstIterator<InputImageType>   expectedIt(input, region);
+  itk::ImageRegionConstIterator<DerivedImageType> magnitudeIt(filter->GetMagnitudeOutput(), region);
+  itk::ImageRegionConstIterator<DerivedImageType> traceIt(filter->GetTraceOutput(), region);
+  itk::ImageRegionConstIterator<DerivedImageType> faIt(filter->GetFractionalAnisotropyOutput(), region);
+  std::vector<itk::ImageRegionConstIterator<DerivedImageType>> eigenValueIts;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    eigenValueIts.emplace_back(filter->GetEigenValueOutput(i), region);
+  }
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++magnitudeIt, ++traceIt, ++faIt)
+  {
+    const TensorType tensor = expectedIt.Get();
+    double           sumOfSquares = 0.0;
+    for (unsigned int c = 0; c < 6; ++c)
+    {
+      sumOfSquares += tensor[c] * tensor[c];
+    }
+    TensorType::EigenValuesArrayType eigenValues;
+    tensor.ComputeEigenValues(eigenValues);
+
+    bool same = std::abs(magnitudeIt.Get() - std::sqrt(sumOfSquares)) < 1e-5 &&
+                std::abs(traceIt.Get() - tensor.GetTrace()) < 1e-5 &&
+                std::abs(faIt.Get() - tensor.GetFractionalAnisotropy()) < 1e-4;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      same = same && std::abs(eigenValueIts[i].Get() - eigenValues[i]) < 1e-5;
+      ++eigenValueIts[i];
+    }
+    if (!same)
+    {
+      std::cerr << "Derived outputs differ at " << expectedIt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The tensor measures do not apply to vectors.
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, Dimension>;
+  using VectorFilterType = itk::SplitComponentsImageFilter<VectorImageType, OutputImageType>;
+  auto vectorFilter = VectorFilterType::New();
+  if (vectorFilter->GetTraceOutput() != nullptr || vectorFilter->GetMagnitudeOutput() == nullptr)
+  {
+    std::cerr << "Unexpected derived outputs of a vector image." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
+// The magnitude is the norm of all the components of the pixels, even when
+// fewer are split, as for 3-vectors in a 2D image with the default
+// TComponents of 2.
+int
+DeriveMagnitudeOfAllComponents()
+{
+  using VectorType = itk::Vector<float, 3>;
+  using InputImageType = itk::Image<VectorType, 2>;
+  using OutputImageType = itk::Image<float, 2>;
+
+  auto                     input = InputImageType::New();
+  InputImageType::SizeType size;
+  size[0] = 23;
+  size[1] = 7;
+  input->SetRegions(size);
+  input->Allocate();
+
+  unsigned int                             value = 0;
+  itk::ImageRegionIterator<InputImageType> inIt(input, input->GetLargestPossibleRegion());
+  for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
+  {
+    VectorType vector;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      vector[c] = static_cast<float>((value++ * 29) % 17) - 8.0f;
+    }
+    inIt.Set(vector);
+  }
+
+  using FilterType = itk::SplitComponentsImageFilter<InputImageType, OutputImageType>;
+  static_assert(FilterType::Components == 2, "The filter must split fewer components than the pixels hold.");
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->ComputeMagnitudeOn();
+
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Magnitude: exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using DerivedImageType = FilterType::DerivedImageType;
+  itk::ImageRegionConstIterator<InputImageType>   expectedIt(input, input->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<DerivedImageType> magnitudeIt(filter->GetMagnitudeOutput(),
+                                                              input->GetLargestPossibleRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++magnitudeIt)
+  {
+    if (std::abs(magnitudeIt.Get() - expectedIt.Get().GetNorm()) > 1e-5)
+    {
+      std::cerr << "Magnitude: differs from the norm of the pixel at " << expectedIt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+} // end anonymous namespace
+
+int
+itkSplitComponentsImageFilterPixelTypesTest(int, char *[])
+{
+  constexpr unsigned int none = 100;
+
+  int result = EXIT_SUCCESS;
+
+  result |= SplitAndCompare<itk::RGBPixel<unsigned char>, unsigned char, 3>("RGB uchar", none);
+  result |= SplitAndCompare<itk::RGBPixel<unsigned char>, unsigned char, 3>("RGB uchar, masked", 1);
+  result |= SplitAndCompare<itk::RGBAPixel<unsigned char>, unsigned char, 4>("RGBA uchar", none);
+  result |= SplitAndCompare<itk::RGBAPixel<unsigned char>, unsigned char, 3>("RGBA uchar to RGB", none);
+  result |= SplitAndCompare<itk::RGBAPixel<unsigned short>, unsigned short, 4>("RGBA ushort", none);
+  result |= SplitAndCompare<itk::Vector<float, 2>, float, 2>("Vector float 2", none);
+  result |= SplitAndCompare<itk::Vector<float, 3>, float, 3>("Vector float 3", none);
+  result |= SplitAndCompare<itk::Vector<float, 3>, double, 3>("Vector float 3 to double", none);
+  result |= SplitAndCompare<itk::SymmetricSecondRankTensor<float, 3>, float, 6>("Tensor float", 4);
+  result |= SplitAndCompare<itk::Vector<double, 4>, double, 4>("Vector double 4", none);
+  result |= SplitVectorImageAndCompare<unsigned char>("VectorImage uchar 4", 4);
+  result |= SplitVectorImageAndCompare<float>("VectorImage float 30", 30);
+  result |= ConvertAndCompare();
+  result |= ConvertOneAndCompare<float>("Conversion of one float component");
+  result |= ConvertOneAndCompare<unsigned char>("Conversion of one unsigned char component");
+  result |= ComputeStatisticsAndCompare();
+  result |= ComputeDoubleStatisticsAndCompare();
+  result |= DeriveAndCompare();
+  result |= DeriveMagnitudeOfAllComponents();
+
+  return result;
+}
@@ -17,6 +17,7 @@
  *=========================================================================*/
 #include "itkImage.h"
 #include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkVector.h"
 
@@ -99,6 +100,21 @@ itkSplitComponentsImageFilterTest(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // The component view reads the same values from the input in place.
+  using ComponentViewType = FilterType::ComponentViewType;
+  ComponentViewType::Pointer view = filter->GetComponentView(1);
+  view->Update();
+  itk::ImageRegionConstIterator<ComponentViewType> viewIt(view, region);
+  itk::ImageRegionConstIterator<OutputImageType>   outputIt(filter->GetOutput(1), region);
+  for (; !viewIt.IsAtEnd(); ++viewIt, ++outputIt)
+  {
+    if (viewIt.Get() != outputIt.Get())
+    {
+      std::cerr << "Component view differs from the split output." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   using ComponentsMaskType = FilterType::ComponentsMaskType;
   ComponentsMaskType componentsMask(false);
   componentsMask[1] = true;
@@ -127,5 +143,115 @@ itkSplitComponentsImageFilterTest(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Only the second component was split by the last update.
+  const itk::SizeValueType numberOfPixels = region.GetNumberOfPixels();
+  if (filter->GetInputBytes() != numberOfPixels * sizeof(VectorType) ||
+      filter->GetOutputBytes() != numberOfPixels * sizeof(PixelType))
+  {
+    std::cerr << "Unexpected statistics: " << filter->GetInputBytes() << " bytes in, " << filter->GetOutputBytes()
+              << " bytes out." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (filter->GetNumberOfExecutedSlabs() == 0 || filter->GetElapsedTime() < 0.0)
+  {
+    std::cerr << "Unexpected timing statistics." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Touching the pages of the outputs first does not change them.
+  filter->FirstTouchOutputsOn();
+  filter->SetNumberOfWorkUnits(4);
+  try
+  {
+    filter->Update();
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionConstIterator<OutputImageType> touchedIt(filter->GetOutput(1), region);
+  for (viewIt.GoToBegin(); !viewIt.IsAtEnd(); ++viewIt, ++touchedIt)
+  {
+    if (viewIt.Get() != touchedIt.Get())
+    {
+      std::cerr << "First touched output differs from the component view." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Updating again recycles the buffer of the last update.
+  filter->ReuseOutputBuffersOn();
+  const PixelType * buffer = nullptr;
+  for (int update = 0; update < 2; ++update)
+  {
+    input->Modified();
+    try
+    {
+      filter->Update();
+    }
+    catch (itk::ExceptionObject & ex)
+    {
+      std::cerr << "Exception caught!" << std::endl;
+      std::cerr << ex << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (update == 1 && filter->GetOutput(1)->GetBufferPointer() != buffer)
+    {
+      std::cerr << "The output buffer was not recycled." << std::endl;
+      return EXIT_FAILURE;
+    }
+    buffer = filter->GetOutput(1)->GetBufferPointer();
+  }
+  itk::ImageRegionConstIterator<OutputImageType> recycledIt(filter->GetOutput(1), region);
+  for (viewIt.GoToBegin(); !viewIt.IsAtEnd(); ++viewIt, ++recycledIt)
+  {
+    if (viewIt.Get() != recycledIt.Get())
+    {
+      std::cerr << "Recycled output differs from the component view." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // In lazy mode, only the updated component is split, and it is kept while
+  // the others are.
+  FilterType::Pointer lazyFilter = FilterType::New();
+  lazyFilter->SetInput(input);
+  lazyFilter->LazyComponentsOn();
+  try
+  {
+    lazyFilter->GetOutput(1)->Update();
+    if (lazyFilter->GetOutput(0)->GetBufferPointer() != nullptr)
+    {
+      std::cerr << "Lazy mode split a component that was not updated." << std::endl;
+      return EXIT_FAILURE;
+    }
+    const PixelType * lazyBuffer = lazyFilter->GetOutput(1)->GetBufferPointer();
+    lazyFilter->GetOutput(0)->Update();
+    if (lazyFilter->GetOutput(1)->GetBufferPointer() != lazyBuffer)
+    {
+      std::cerr << "Lazy mode did not keep the component split before." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & ex)
+  {
+    std::cerr << "Exception caught!" << std::endl;
+    std::cerr << ex << std::endl;
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionConstIterator<InputImageType>  lazyInputIt(input, region);
+  itk::ImageRegionConstIterator<OutputImageType> lazyIt0(lazyFilter->GetOutput(0), region);
+  itk::ImageRegionConstIterator<OutputImageType> lazyIt1(lazyFilter->GetOutput(1), region);
+  for (; !lazyInputIt.IsAtEnd(); ++lazyInputIt, ++lazyIt0, ++lazyIt1)
+  {
+    if (lazyIt0.Get() != lazyInputIt.Get()[0] || lazyIt1.Get() != lazyInputIt.Get()[1])
+    {
+      std::cerr << "Lazy outputs differ from the input components." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,115 @@
+# ==========================================================================
+#
+#   Copyright NumFOCUS
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#          https://www.apache.org/licenses/LICENSE-2.0.txt
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+# ==========================================================================
+
+"""Split the components of NumPy arrays without intermediate ITK images.
+
+The array of shape (..., C) is viewed in place as an itk.VectorImage, and the
+SplitComponentsImageFilter writes each component into the buffer of its
+output image, which is returned as a NumPy view of that buffer.  The only
+copy made is the split itself, on all the work units of the filter.
+"""
+
+import numpy as np
+
+import itk
+
+__all__ = ["split_components"]
+
+
+def split_components(array, components=None, copy=True, number_of_work_units=None):
+    """Split the last axis of an array of shape (..., C) into C arrays.
+
+    Parameters
+    ----------
+    array : array_like
+        The image, with the components along the last axis, e.g. from
+        itk.array_view_from_image() of a multi-component image, so with 2 or
+        more spatial axes.  Any object exposing the buffer or array interface
+        is accepted.
+    components : sequence of int, optional
+        The components to return, in order.  All by default.
+    copy : bool, optional
+        If True, the default, return C-contiguous arrays filled by the
+        multi-threaded filter.  If False, return strided views of the input
+        that share its memory, without any copy.
+    number_of_work_units : int, optional
+        Number of work units of the filter.  By default, that of the global
+        multi-threader.
+
+    Returns
+    -------
+    list of numpy.ndarray
+        One array of shape (...) per selected component.
+
+    Raises
+    ------
+    ValueError
+        If the array has fewer than 2 spatial axes, or if the filter is not
+        wrapped for its dimension, pixel type and number of components.
+    IndexError
+        If a component is out of range for the last axis of the array.
+    """
+    array = np.asarray(array)
+    if array.ndim < 3:
+        raise ValueError(
+            "Expected an array of shape (..., C) with 2 or more spatial axes, got shape {}.".format(array.shape)
+        )
+    number_of_components = array.shape[-1]
+    if components is None:
+        components = range(number_of_components)
+    components = [int(component) for component in components]
+    for component in components:
+        if not 0 <= component < number_of_components:
+            raise IndexError("Component {} is out of range for {} components.".format(component, number_of_components))
+
+    if not copy:
+        return [array[..., component] for component in components]
+
+    # The image view requires a contiguous buffer; only other arrays are
+    # copied here.
+    array = np.ascontiguousarray(array)
+    try:
+        input_image = itk.image_view_from_array(array, is_vector=True)
+
+        pixel_type, dimension = itk.template(input_image)[1][:2]
+        try:
+            # An RGB(A) pixel, as chosen for 3 or 4 unsigned char components.
+            component_type = itk.template(pixel_type)[1][0]
+            filter_type = itk.SplitComponentsImageFilter[
+                type(input_image), itk.Image[component_type, dimension], number_of_components
+            ]
+        except KeyError:
+            component_type = pixel_type
+            filter_type = itk.SplitComponentsImageFilter[type(input_image), itk.Image[component_type, dimension]]
+    except (KeyError, TypeError) as error:
+        raise ValueError(
+            "The split of {}D images of {} with {} components is not wrapped.".format(
+                array.ndim - 1, array.dtype, number_of_components
+            )
+        ) from error
+
+    split_filter = filter_type.New()
+    split_filter.SetInput(input_image)
+    for component in range(number_of_components):
+        split_filter.SetComponentSelected(component, component in components)
+    if number_of_work_units is not None:
+        split_filter.SetNumberOfWorkUnits(int(number_of_work_units))
+    split_filter.Update()
+
+    # The views keep the output images, and so their buffers, alive.
+    return [itk.array_view_from_image(split_filter.GetOutput(component)) for component in components]
@@ -0,0 +1,71 @@
+# ==========================================================================
+#
+#   Copyright NumFOCUS
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#          https://www.apache.org/licenses/LICENSE-2.0.txt
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+# ==========================================================================
+
+# Split NumPy arrays of several pixel layouts with the split_components
+# helper, and compare the components with slices of the arrays.
+#
+# Usage: split_components_test.py <directory of split_components.py>
+
+import sys
+
+import numpy as np
+
+sys.path.insert(0, sys.argv[1])
+from split_components import split_components  # noqa: E402
+
+
+def check(name, array, components=None, copy=True):
+    expected_components = range(array.shape[-1]) if components is None else components
+    split = split_components(array, components=components, copy=copy, number_of_work_units=3)
+    if len(split) != len(expected_components):
+        raise AssertionError("{}: {} components instead of {}".format(name, len(split), len(expected_components)))
+    for component, result in zip(expected_components, split):
+        if result.shape != array.shape[:-1] or not np.array_equal(result, array[..., component]):
+            raise AssertionError("{}: component {} differs from the array".format(name, component))
+        if copy and not result.flags.c_contiguous:
+            raise AssertionError("{}: component {} is not contiguous".format(name, component))
+
+
+rng = np.random.default_rng(0)
+for shape in ((17, 23), (5, 17, 23)):
+    dimension = "{}D".format(len(shape))
+    rgb = rng.integers(0, 256, size=shape + (3,), dtype=np.uint8)
+    check("uint8 RGB " + dimension, rgb)
+    check("uint8 RGB " + dimension + " selected", rgb, components=[2, 0])
+    check("uint8 RGB " + dimension + " views", rgb, copy=False)
+
+    two_channels = rng.integers(0, 256, size=shape + (2,), dtype=np.uint8)
+    check("uint8 2 channels " + dimension, two_channels)
+
+    five_channels = rng.standard_normal(size=shape + (5,)).astype(np.float32)
+    check("float32 5 channels " + dimension, five_channels)
+    check("float32 5 channels " + dimension + " selected", five_channels, components=[4, 1, 3])
+    # A non-contiguous array is copied before the split.
+    check("float32 5 channels " + dimension + " strided", five_channels[..., ::2, :])
+
+# Arrays that are not images of components are rejected.
+for name, array, components, error_type in (
+    ("1D", np.zeros((10, 3), dtype=np.uint8), None, ValueError),
+    ("component out of range", np.zeros((4, 4, 3), dtype=np.uint8), [3], IndexError),
+):
+    try:
+        split_components(array, components=components)
+    except error_type:
+        pass
+    else:
+        raise AssertionError("{}: expected a {}".format(name, error_type.__name__))